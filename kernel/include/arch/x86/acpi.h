@@ -0,0 +1,45 @@
+/**
+ * @file acpi.h
+ * @brief Tablas ACPI: apagado (isa-debug-exit de QEMU, S5) y CPUs de la MADT
+ */
+#ifndef ARCH_X86_ACPI_H
+#define ARCH_X86_ACPI_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define QEMU_DEBUG_EXIT_PORT 0xF4   /* -device isa-debug-exit,iobase=0xf4,iosize=0x04 */
+
+/**
+ * @brief Termina QEMU con código de salida (status << 1) | 1
+ *
+ * Si no hay dispositivo isa-debug-exit en 'port' la escritura se ignora y
+ * la función vuelve.
+ */
+void qemu_debug_exit(uint16_t port, uint32_t status);
+
+/**
+ * @brief Entra en S5 (soft-off) usando la FADT y el objeto \_S5 del DSDT
+ *
+ * Si no hay tablas ACPI utilizables prueba los puertos fijos de QEMU,
+ * Bochs y VirtualBox.
+ * @return Sólo vuelve (con -1) si ningún método apagó la máquina
+ */
+int acpi_poweroff(void);
+
+/**
+ * @brief IDs de LAPIC de los procesadores habilitados según la MADT
+ * @param apic_ids   Destino (hasta 'max' entradas, el BSP incluido)
+ * @param lapic_base Dirección física de los registros del LAPIC
+ * @return Nº de CPUs, o -1 si no hay MADT
+ */
+int acpi_madt_lapics(uint8_t* apic_ids, int max, uint32_t* lapic_base);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARCH_X86_ACPI_H */
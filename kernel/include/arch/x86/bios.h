@@ -0,0 +1,39 @@
+/**
+ * @file bios.h
+ * @brief Datos de la BIOS en memoria baja: EBDA y sumas de sus tablas
+ *
+ * La tabla MP (smp.c) y el RSDP de ACPI (acpi.c) se buscan en el primer KiB
+ * de la EBDA y en el área de la ROM; ambas estructuras se validan con una
+ * suma de bytes que debe dar 0.
+ */
+#ifndef ARCH_X86_BIOS_H
+#define ARCH_X86_BIOS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BIOS_BDA_EBDA   0x40E           /* BDA: segmento de la EBDA */
+
+/** @brief Dirección física de la EBDA (0 si la BDA no la indica) */
+static inline uint32_t bios_ebda_base(void) {
+    const volatile uint16_t* seg;
+    // La dirección pasa por asm para que GCC no la trate como un objeto de tamaño 0 (-Warray-bounds)
+    __asm__("" : "=r"(seg) : "0"(BIOS_BDA_EBDA));
+    return (uint32_t)*seg << 4;
+}
+
+/** @brief 1 si los 'n' bytes de 'p' suman 0 (mod 256) */
+static inline int bios_checksum_ok(const void* p, uint32_t n) {
+    uint8_t sum = 0;
+    for (uint32_t i = 0; i < n; i++) sum += ((const uint8_t*)p)[i];
+    return sum == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARCH_X86_BIOS_H */
@@ -3,7 +3,9 @@
 
 /* C handlers (definidos en faults.c) */
 void fault_handler(uint32_t vec, uint32_t err);
+void pf_handler(uint32_t vec, uint32_t err);
 void mf_handler(void);
+void nm_handler(void);
 
 /* ASM stubs (definidos en faults.S / irq_stubs.S) */
 void isr6_stub(void);   /* #UD */
@@ -13,4 +15,7 @@ void isr13_stub(void);  /* #GP */
 void isr14_stub(void);  /* #PF */
 
 void irq0_stub(void);
-void irq1_stub(void);
\ No newline at end of file
+void irq1_stub(void);
+void irq12_stub(void);
+void ipi_stub(void);       /* IPI_WAKEUP_VEC */
+void spurious_stub(void);  /* LAPIC_SPURIOUS_VEC */
@@ -0,0 +1,58 @@
+/**
+ * @file fpu.h
+ * @brief x87/SSE: CR0.TS y FXSAVE/FXRSTOR para el cambio de contexto perezoso
+ *
+ * mb1_start.S deja MP=1, NE=1, EM=0, TS=0 y CR4.OSFXSR=1. Con TS=1 la
+ * primera instrucción x87/SSE provoca #NM (vector 7); el planificador
+ * (thread.c) la usa para guardar el estado sólo cuando otro hilo lo pide.
+ */
+#ifndef ARCH_X86_FPU_H
+#define ARCH_X86_FPU_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CR0_TS          (1u << 3)
+#define FPU_AREA_SIZE   512             /* FXSAVE: 512 bytes alineados a 16 */
+#define FPU_DEFAULT_CW  0x037F          /* excepciones x87 enmascaradas */
+#define FPU_DEFAULT_MXCSR 0x1F80        /* excepciones SSE enmascaradas */
+
+static inline uint32_t read_cr0(void) {
+    uint32_t v;
+    __asm__ __volatile__("mov %%cr0, %0" : "=r"(v));
+    return v;
+}
+
+/** @brief TS=1: el próximo uso de x87/SSE da #NM */
+static inline void fpu_set_ts(void) {
+    __asm__ __volatile__("mov %0, %%cr0" :: "r"(read_cr0() | CR0_TS) : "memory");
+}
+
+/** @brief TS=0 */
+static inline void fpu_clear_ts(void) {
+    __asm__ __volatile__("clts" ::: "memory");
+}
+
+static inline void fpu_fxsave(void* area) {
+    __asm__ __volatile__("fxsave (%0)" :: "r"(area) : "memory");
+}
+
+static inline void fpu_fxrstor(const void* area) {
+    __asm__ __volatile__("fxrstor (%0)" :: "r"(area) : "memory");
+}
+
+/** @brief Estado inicial: el mismo que deja mb1_start.S */
+static inline void fpu_reset(void) {
+    uint16_t cw = FPU_DEFAULT_CW;
+    uint32_t mxcsr = FPU_DEFAULT_MXCSR;
+    __asm__ __volatile__("fninit\n\tfldcw %0\n\tldmxcsr %1" :: "m"(cw), "m"(mxcsr));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARCH_X86_FPU_H */
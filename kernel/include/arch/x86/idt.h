@@ -20,6 +20,7 @@ struct idt_ptr {
 /* idt.c */
 void idt_set_gate(int n, uint32_t handler, uint16_t sel, uint8_t type_attr);
 void interrupts_init(void);
+void idt_load(void);   /* carga la IDT ya construida (APs) */
 
 /* PIC helpers (expuestos por si quieres usarlos en otros lugares) */
 void pic_remap_mask_all(void);
@@ -0,0 +1,60 @@
+/**
+ * @file lapic.h
+ * @brief APIC local: identificación, EOI e IPIs entre CPUs
+ *
+ * Las IRQ de dispositivos siguen entrando por el PIC 8259 al BSP (modo
+ * "virtual wire"); el LAPIC sólo se usa para arrancar y despertar CPUs.
+ */
+#ifndef ARCH_X86_LAPIC_H
+#define ARCH_X86_LAPIC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LAPIC_DEFAULT_BASE 0xFEE00000u
+#define LAPIC_SPURIOUS_VEC 0xFF
+#define IPI_WAKEUP_VEC     0xF0     /* saca a una CPU de hlt */
+
+/**
+ * @brief Fija la dirección de los registros (MADT/MP); por defecto LAPIC_DEFAULT_BASE
+ */
+void lapic_set_base(uint32_t base);
+
+/**
+ * @brief Habilita el LAPIC de la CPU actual (SVR) y acepta todas las prioridades
+ */
+void lapic_enable(void);
+
+/**
+ * @brief ID de LAPIC de la CPU actual
+ */
+uint8_t lapic_id(void);
+
+/**
+ * @brief Fin de interrupción para vectores entregados por el LAPIC (IPIs)
+ */
+void lapic_eoi(void);
+
+/**
+ * @brief IPI fija con 'vector' a la CPU 'apic_id'
+ */
+void lapic_send_ipi(uint8_t apic_id, uint8_t vector);
+
+/**
+ * @brief INIT a 'apic_id' (la deja esperando un SIPI)
+ */
+void lapic_send_init(uint8_t apic_id);
+
+/**
+ * @brief STARTUP a 'apic_id': empieza en modo real en page * 4096
+ */
+void lapic_send_sipi(uint8_t apic_id, uint8_t page);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARCH_X86_LAPIC_H */
@@ -0,0 +1,48 @@
+#pragma once
+#include <stdint.h>
+
+/* Paginación x86 de 32 bits: identidad con páginas de 4 MiB (PSE) para
+   todo el espacio físico, salvo una ventana de 4 KiB por página reservada
+   para mapeos bajo demanda (mmap). */
+
+#define PAGE_SIZE       4096u
+#define PAGE_MASK       (~(PAGE_SIZE - 1))
+
+#define PTE_PRESENT     0x001u
+#define PTE_WRITE       0x002u
+#define PTE_USER        0x004u
+#define PTE_ACCESSED    0x020u
+#define PTE_DIRTY       0x040u
+#define PDE_4M          0x080u
+
+/* Ventana virtual para mmap (512 MiB): no se mapea en identidad */
+#define VM_WINDOW_BASE  0x80000000u
+#define VM_WINDOW_END   0xA0000000u
+
+/* Error code de #PF */
+#define PF_ERR_PRESENT  0x1u
+#define PF_ERR_WRITE    0x2u
+
+void paging_init(void);
+int  paging_enabled(void);
+
+/* Asegura que existe la tabla de páginas que cubre 'va' (sólo ventana). 0 si ok */
+int  paging_prepare(uint32_t va);
+
+/* Entrada de la tabla de páginas para 'va' dentro de la ventana (NULL si no hay) */
+volatile uint32_t* paging_pte(uint32_t va);
+
+void paging_map(uint32_t va, uint32_t pa, uint32_t flags);
+void paging_unmap(uint32_t va);
+
+/* Dirección del directorio (para CR3 en otros núcleos) */
+uint32_t paging_cr3(void);
+
+static inline void invlpg(uint32_t va){
+    __asm__ volatile("invlpg (%0)" :: "r"(va) : "memory");
+}
+
+static inline uint32_t read_cr2(void){
+    uint32_t v; __asm__ volatile("mov %%cr2, %0" : "=r"(v));
+    return v;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file smp.h
+ * @brief Arranque de los procesadores de aplicación (AP) y datos por CPU
+ *
+ * Cada CPU tiene su cpu_t, su GDT y su pila. El descriptor 0x18 de su GDT
+ * tiene como base su propio cpu_t y se carga en %fs, así que this_cpu() es
+ * una sola instrucción (%fs:0 apunta al propio cpu_t). Las stubs de
+ * interrupción guardan y restauran %fs pero nunca lo cambian.
+ *
+ * Los AP esperan trabajo en un bucle hlt; smp_call() les pasa una función
+ * y los despierta con una IPI. Las IRQ de dispositivos sólo llegan al BSP.
+ */
+#ifndef ARCH_X86_SMP_H
+#define ARCH_X86_SMP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SMP_MAX_CPUS     8
+#define SMP_AP_STACK     (16 * 1024)
+#define SMP_TRAMPOLINE   0x8000u        /* página baja para el código de arranque de los AP */
+
+#define GDT_PERCPU_SEL   0x18
+
+typedef void (*smp_fn_t)(void* arg);
+
+typedef struct cpu {
+    struct cpu*       self;             /* %fs:0 */
+    uint32_t          id;               /* índice lógico: 0 = BSP */
+    uint8_t           apic_id;
+    volatile uint32_t online;
+    uint64_t          gdt[4];           /* null, código, datos, este cpu_t */
+    uint8_t*          stack;            /* base de la pila (AP) */
+    /* buzón de trabajo (smp_call) */
+    volatile smp_fn_t work_fn;
+    void* volatile    work_arg;
+    volatile uint32_t work_done;        /* trabajos completados */
+    uint32_t          wakeups;          /* salidas de hlt */
+} cpu_t;
+
+static inline cpu_t* this_cpu(void) {
+    cpu_t* c;
+    __asm__ __volatile__("mov %%fs:0, %0" : "=r"(c));
+    return c;
+}
+
+static inline void cpu_relax(void) {
+    __asm__ __volatile__("pause" ::: "memory");
+}
+
+/**
+ * @brief Instala los datos por CPU del BSP y arranca los AP (MADT o tabla MP)
+ *
+ * Llamar con paginación activa y después de tsc_calibrate(). Con "nosmp"
+ * en la línea de comandos sólo se prepara el BSP.
+ * @return Nº de CPUs en marcha (≥ 1)
+ */
+int smp_init(void);
+
+/** @brief CPUs en marcha (1 hasta smp_init) */
+int smp_cpu_count(void);
+
+/** @brief Índice lógico de la CPU actual (0 = BSP) */
+static inline uint32_t smp_cpu_id(void) { return this_cpu()->id; }
+
+/** @brief cpu_t del índice lógico 'i' (NULL si no existe) */
+cpu_t* smp_cpu(int i);
+
+/**
+ * @brief Ejecuta fn(arg) en el AP 'cpu' (no bloquea)
+ * @return 0 si se encargó, -1 si no existe, no está en marcha o está ocupado
+ */
+int smp_call(int cpu, smp_fn_t fn, void* arg);
+
+/**
+ * @brief Espera a que el AP 'cpu' termine su trabajo
+ */
+void smp_wait(int cpu);
+
+/** @brief ISR de IPI_WAKEUP_VEC: sólo EOI, el trabajo lo recoge el bucle idle */
+void smp_ipi_isr(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARCH_X86_SMP_H */
@@ -0,0 +1,38 @@
+/**
+ * @file tsc.h
+ * @brief Time Stamp Counter: lectura y conversión a tiempo real
+ */
+#ifndef ARCH_X86_TSC_H
+#define ARCH_X86_TSC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/**
+ * @brief Mide la frecuencia del TSC contra el PIT (requiere pit_init e IRQs activas)
+ *
+ * Bloquea unos 100 ms. Sin calibrar, tsc_khz() devuelve 0 y las
+ * conversiones dan 0.
+ */
+void tsc_calibrate(void);
+
+/** @brief Ciclos por milisegundo medidos (0 = sin calibrar) */
+uint32_t tsc_khz(void);
+
+/** @brief Ciclos → microsegundos */
+uint64_t tsc_to_us(uint64_t cycles);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARCH_X86_TSC_H */
@@ -12,22 +12,39 @@
 extern "C" {
 #endif
 
+/* Tipo de fichero (bits S_IFMT de c_mode) */
+#define CPIO_MODE_TYPE  0170000u
+#define CPIO_MODE_DIR   0040000u
+#define CPIO_MODE_REG   0100000u
+
+#define CPIO_NONE       0xFFFFFFFFu
+
 /**
- * @brief Convierte 8 caracteres hexadecimales a un uint32_t
- * @param s Cadena con 8 caracteres hexadecimales
- * @return Valor convertido
+ * @brief Entrada del índice: apunta directamente dentro de la imagen CPIO
  */
-static uint32_t hx8(const char *s);
+typedef struct {
+    const char* name;       /* ruta normalizada (sin "./" ni "/" inicial) */
+    const void* data;       /* contenido, sin copia */
+    uint32_t    size;
+    uint32_t    mode;
+    uint32_t    hash;
+    uint32_t    first_child;    /* índice del primer hijo (CPIO_NONE si no hay) */
+    uint32_t    next_sibling;   /* siguiente entrada del mismo directorio */
+} cpio_entry_t;
 
 /**
- * @brief Alinea un valor a 4 bytes
- * @param x Valor a alinear
- * @return Valor alineado
+ * @brief Índice hash construido una sola vez sobre la imagen
  */
-static uint32_t align4(uint32_t x);
+typedef struct {
+    cpio_entry_t* entries;
+    uint32_t      count;
+    uint32_t*     buckets;      /* índice+1 de la entrada, 0 = libre */
+    uint32_t      mask;         /* nº de buckets - 1 (potencia de dos) */
+    uint32_t      root_first;   /* primer hijo del directorio raíz */
+} cpio_index_t;
 
 /**
- * @brief Busca un archivo en un archivo CPIO en memoria
+ * @brief Busca un archivo en un archivo CPIO en memoria (recorrido lineal)
  * @param cpio Puntero a la imagen CPIO en memoria
  * @param size Tamaño de la imagen CPIO
  * @param path Ruta del archivo a buscar
@@ -36,8 +53,35 @@ static uint32_t align4(uint32_t x);
  */
 const void* cpio_find(const void *cpio, uint32_t size, const char *path, uint32_t *out_len);
 
+/**
+ * @brief Recorre la imagen una vez y construye la tabla hash de rutas
+ * @param idx Índice a rellenar (se reserva memoria con malloc)
+ * @param cpio Imagen CPIO "newc" en memoria
+ * @param size Tamaño de la imagen
+ * @return Número de entradas indexadas, o -1 si no hay memoria
+ */
+int cpio_index_build(cpio_index_t* idx, const void* cpio, uint32_t size);
+
+/**
+ * @brief Libera la memoria del índice (la imagen no se toca)
+ */
+void cpio_index_free(cpio_index_t* idx);
+
+/**
+ * @brief Búsqueda O(1) de una ruta en el índice
+ * @return Entrada encontrada o NULL
+ */
+const cpio_entry_t* cpio_lookup(const cpio_index_t* idx, const char* path);
+
+/**
+ * @brief Itera los hijos directos de un directorio ("" o "/" = raíz)
+ * @param cookie Estado de la iteración; inicializar a 0 antes de la primera llamada
+ * @return Siguiente entrada o NULL al terminar
+ */
+const cpio_entry_t* cpio_dir_next(const cpio_index_t* idx, const char* dir, uint32_t* cookie);
+
 #ifdef __cplusplus
 }
 #endif
 
-#endif /* FS_CPIO_H */
\ No newline at end of file
+#endif /* FS_CPIO_H */
@@ -6,6 +6,7 @@
 #define DRIVERS_INPUT_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,7 +39,35 @@ size_t kbd_read(char *dst, size_t max);
 /**
  * @brief Tamaño del buffer interno de teclado
  */
-#define KBD_BUF_SIZE 256
+#define KBD_BUF_SIZE 256     /* potencia de 2 (kernel/ring.h) */
+
+/**
+ * @brief Evento de tecla: código set 1 sin el bit de soltado, con KBD_SC_EXT
+ *        si venía precedido de 0xE0 (cursores, Ctrl/Alt derechos, ...)
+ */
+typedef struct {
+    uint16_t scancode;
+    uint8_t  pressed;   /* 1 = pulsada, 0 = soltada */
+    uint64_t tsc;       /* rdtsc() en la ISR */
+} kbd_event_t;
+
+#define KBD_SC_EXT     0xE000u
+#define KBD_SC_PAUSE   0xE100u  /* secuencia E1: pulsar y soltar a la vez */
+#define KBD_EVQ_SIZE   128      /* potencia de 2 */
+
+/**
+ * @brief Saca hasta 'max' eventos de tecla pendientes (no bloqueante)
+ * @return Nº de eventos copiados en 'dst'
+ *
+ * La cola es independiente del buffer de caracteres: kbd_read() sigue
+ * recibiendo el texto traducido para la consola.
+ */
+size_t kbd_read_events(kbd_event_t *dst, size_t max);
+
+/**
+ * @brief Eventos descartados porque la cola estaba llena
+ */
+uint32_t kbd_events_dropped(void);
 
 typedef enum {
     KBD_LAYOUT_US = 0,
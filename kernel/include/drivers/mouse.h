@@ -0,0 +1,57 @@
+/**
+ * @file mouse.h
+ * @brief Ratón PS/2 en el puerto auxiliar del 8042 (IRQ12)
+ *
+ * La ISR arma paquetes de 3 bytes (o 4 con rueda, IntelliMouse) y sólo
+ * acumula el movimiento; el consumidor recoge un delta por consulta con
+ * mouse_poll(), sin una entrada por paquete.
+ */
+#ifndef DRIVERS_MOUSE_H
+#define DRIVERS_MOUSE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MOUSE_BTN_LEFT   0x01
+#define MOUSE_BTN_RIGHT  0x02
+#define MOUSE_BTN_MIDDLE 0x04
+
+typedef struct {
+    int32_t  dx, dy;    /* acumulado desde la consulta anterior; dy > 0 = hacia arriba */
+    int32_t  dz;        /* rueda; dz > 0 = hacia el usuario */
+    uint8_t  buttons;   /* MOUSE_BTN_* del último paquete */
+    uint32_t packets;   /* paquetes fundidos en este delta */
+    uint64_t tsc;       /* rdtsc() del último paquete */
+} mouse_state_t;
+
+/**
+ * @brief Activa el puerto auxiliar, programa el ratón y desenmascara IRQ12
+ *        (e IRQ2, la cascada). Llamar con las interrupciones deshabilitadas.
+ * @return 0 si hay ratón, -1 si no responde
+ */
+int mouse_init(void);
+
+/**
+ * @brief Indica si mouse_init encontró un ratón
+ */
+int mouse_present(void);
+
+/**
+ * @brief Rutina de servicio de interrupción del ratón (IRQ12)
+ */
+void mouse_isr(void);
+
+/**
+ * @brief Recoge y pone a cero el movimiento acumulado
+ * @return 1 si hubo movimiento o cambio de botones desde la última consulta
+ */
+int mouse_poll(mouse_state_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DRIVERS_MOUSE_H */
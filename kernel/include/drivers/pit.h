@@ -17,6 +17,11 @@ extern "C" {
  */
 void pit_init(uint32_t hz);
 
+/**
+ * @brief Frecuencia programada con pit_init() (0 si aún no se ha iniciado)
+ */
+uint32_t pit_hz(void);
+
 /**
  * @brief Rutina de servicio de interrupción para el PIT (IRQ0)
  */
@@ -0,0 +1,62 @@
+/**
+ * @file ramdisk.h
+ * @brief Disco en RAM respaldado por un módulo Multiboot (sectores de 512 bytes)
+ */
+#ifndef DRIVERS_RAMDISK_H
+#define DRIVERS_RAMDISK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RAMDISK_SECTOR_SIZE 512
+
+/**
+ * @brief Asocia el disco RAM a una región de memoria
+ * @param base Inicio de la imagen (p.ej. un módulo Multiboot)
+ * @param size Tamaño en bytes (se trunca a sectores completos)
+ */
+void ramdisk_attach(void* base, uint32_t size);
+
+/**
+ * @brief Busca el módulo "ramdisk" (o el único módulo cargado) y lo asocia
+ * @return 0 si se encontró imagen, -1 si no
+ */
+int ramdisk_init_from_modules(void);
+
+/**
+ * @brief Indica si hay una imagen asociada
+ */
+int ramdisk_present(void);
+
+/**
+ * @brief Número de sectores de la imagen
+ */
+uint32_t ramdisk_sectors(void);
+
+/**
+ * @brief Copia 'count' sectores a partir de 'lba' (con comprobación de límites)
+ * @return 0 si ok, -1 si el rango se sale de la imagen
+ */
+int ramdisk_read(void* dst, uint32_t lba, uint32_t count);
+
+/**
+ * @brief Escribe 'count' sectores a partir de 'lba' (con comprobación de límites)
+ * @return 0 si ok, -1 si el rango se sale de la imagen
+ */
+int ramdisk_write(const void* src, uint32_t lba, uint32_t count);
+
+/**
+ * @brief Acceso sin copia: puntero directo a los sectores pedidos
+ * @return Puntero dentro de la imagen o NULL si el rango no es válido
+ */
+const void* ramdisk_map(uint32_t lba, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DRIVERS_RAMDISK_H */
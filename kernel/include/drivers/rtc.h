@@ -0,0 +1,46 @@
+/**
+ * @file rtc.h
+ * @brief Reloj de tiempo real (CMOS MC146818) para la hora de pared
+ *
+ * El CMOS se lee una sola vez en rtc_init(); a partir de ahí la hora se
+ * obtiene sumando el tiempo transcurrido medido con el TSC (o con el PIT
+ * si el TSC no está calibrado), sin volver a tocar los puertos.
+ */
+#ifndef DRIVERS_RTC_H
+#define DRIVERS_RTC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint16_t year;      /* completo, p.ej. 2025 */
+    uint8_t  mon;       /* 1..12 */
+    uint8_t  mday;      /* 1..31 */
+    uint8_t  hour, min, sec;
+} rtc_time_t;
+
+/**
+ * @brief Lee el CMOS (a salvo de la actualización en curso) y fija la base
+ *        de tiempo. Llamar después de tsc_calibrate().
+ * @return 0 si la fecha es válida, -1 si no (se usa 2025-01-01 00:00 UTC)
+ */
+int rtc_init(void);
+
+/**
+ * @brief Microsegundos desde 1970-01-01 00:00 UTC
+ */
+uint64_t rtc_now_us(void);
+
+/**
+ * @brief Segundos desde 1970 → fecha y hora
+ */
+void rtc_from_epoch(uint32_t secs, rtc_time_t* t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DRIVERS_RTC_H */
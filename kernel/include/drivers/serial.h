@@ -0,0 +1,47 @@
+/**
+ * @file serial.h
+ * @brief Driver del puerto serie 16550 (UART) en modo sondeo
+ */
+#ifndef DRIVERS_SERIAL_H
+#define DRIVERS_SERIAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SERIAL_COM1 0x3F8
+
+/**
+ * @brief Programa la UART a 'baud' 8N1 con FIFO y comprueba que responde
+ * @return 0 si hay UART, -1 si no (las demás funciones no hacen nada)
+ */
+int serial_init(uint16_t port, uint32_t baud);
+
+/**
+ * @brief Indica si serial_init encontró la UART
+ */
+int serial_present(void);
+
+/**
+ * @brief Envía un byte (espera a que el registro de transmisión esté libre)
+ */
+void serial_putc(char c);
+
+/**
+ * @brief Envía 'n' bytes
+ */
+void serial_write(const char* s, size_t n);
+
+/**
+ * @brief Lee un byte si hay (-1 si no hay datos)
+ */
+int serial_getc(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DRIVERS_SERIAL_H */
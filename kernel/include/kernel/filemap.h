@@ -0,0 +1,40 @@
+/**
+ * @file filemap.h
+ * @brief Carga de un fichero completo en una región contigua de memoria
+ *
+ * Orden de preferencia:
+ *  1. fichero del initrd (/initrd/...)        → puntero directo, sin copia
+ *  2. módulo Multiboot con el mismo nombre    → puntero directo, sin copia
+ *  3. fichero FatFs                           → una única lectura a un buffer del heap
+ */
+#ifndef KERNEL_FILEMAP_H
+#define KERNEL_FILEMAP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const uint8_t* data;
+    uint32_t       size;
+    uint8_t        owned;   /* 1 si 'data' se reservó con malloc */
+} kfile_map_t;
+
+/**
+ * @brief Deja el fichero 'path' accesible como región contigua
+ * @return 0 si ok, -1 (errno) si no existe o no hay memoria
+ */
+int kfile_map(const char* path, kfile_map_t* m);
+
+/**
+ * @brief Libera la región (sólo si se copió al heap)
+ */
+void kfile_unmap(kfile_map_t* m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_FILEMAP_H */
@@ -0,0 +1,65 @@
+/**
+ * @file idle.h
+ * @brief Trabajo diferido y tareas de fondo que se ejecutan cuando la CPU espera
+ *
+ * El trabajo encolado con defer_call() lo ejecuta el hilo que llame antes a
+ * kernel_idle() (esperas de teclado), idle_run() (I_Sleep, entre tics de
+ * Doom) o defer_drain(), sea cual sea el que lo encoló. Los trabajos salen
+ * de uno en uno y en orden FIFO aunque varios hilos lleguen a la vez, así
+ * que un trabajo puede contar con que el anterior ha terminado. Nunca se
+ * ejecutan desde una ISR ni en un AP: pueden llamar a malloc y a FatFs
+ * (que no es reentrante: como en el resto del kernel, sólo un hilo debe
+ * usar ficheros FAT).
+ *
+ * Las tareas de idle_register() sólo las ejecuta el hilo que las registró
+ * (todos, si se registraron antes de thread_init()). defer_call() e
+ * idle_register() se pueden llamar desde cualquier hilo, pero no desde una
+ * ISR ni desde un AP.
+ */
+#ifndef KERNEL_IDLE_H
+#define KERNEL_IDLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DEFER_MAX       64      /* trabajos pendientes como máximo */
+#define IDLE_MAX_HOOKS  8
+
+typedef void (*defer_fn_t)(void* arg);
+typedef void (*idle_hook_t)(void);
+
+/**
+ * @brief Encola fn(arg) para ejecutarla más tarde, en orden FIFO
+ * @return 0 si se encoló, -1 si la cola está llena (el llamante decide)
+ */
+int defer_call(defer_fn_t fn, void* arg);
+
+/**
+ * @brief Ejecuta todo el trabajo pendiente ahora mismo (fsync, close, exit)
+ */
+void defer_drain(void);
+
+/**
+ * @brief Registra una tarea que se consulta en cada pasada de idle del hilo actual
+ * @return 0 si ok, -1 si no caben más
+ */
+int idle_register(idle_hook_t hook);
+
+/**
+ * @brief Una pasada de fondo: tareas registradas y trabajo diferido
+ * @return Nº de trabajos diferidos ejecutados
+ */
+int idle_run(void);
+
+/**
+ * @brief idle_run() y, si no había nada que hacer, hlt hasta la siguiente IRQ
+ *        (o, si hay otros hilos listos, cederles la CPU hasta el siguiente tic)
+ */
+void kernel_idle(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_IDLE_H */
@@ -0,0 +1,42 @@
+/**
+ * @file initrd.h
+ * @brief initrd CPIO cargado como módulo Multiboot ("initrd"), indexado al arrancar
+ */
+#ifndef KERNEL_INITRD_H
+#define KERNEL_INITRD_H
+
+#include <drivers/cpio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Prefijo de ruta bajo el que newlib ve los ficheros del initrd */
+#define INITRD_PREFIX "/initrd/"
+
+/**
+ * @brief Busca el módulo "initrd" y construye su índice hash
+ * @return Número de entradas, o -1 si no hay initrd
+ */
+int initrd_init(void);
+
+/**
+ * @brief Índice del initrd (NULL si no hay)
+ */
+const cpio_index_t* initrd_index(void);
+
+/**
+ * @brief Si 'path' empieza por INITRD_PREFIX devuelve el resto de la ruta, si no NULL
+ */
+const char* initrd_subpath(const char* path);
+
+/**
+ * @brief Busca una ruta relativa al initrd
+ */
+const cpio_entry_t* initrd_lookup(const char* subpath);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_INITRD_H */
@@ -0,0 +1,78 @@
+/**
+ * @file iostat.h
+ * @brief Contadores de E/S por fichero, por dispositivo y de stdio
+ *
+ * Los tiempos se acumulan en ciclos del TSC y se convierten a µs al
+ * mostrarlos (tsc_calibrate). El resumen se lee como un fichero más en
+ * IOSTAT_PATH o se vuelca por consola al salir con "iostat" en la cmdline.
+ */
+#ifndef KERNEL_IOSTAT_H
+#define KERNEL_IOSTAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <arch/x86/tsc.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IOSTAT_PATH       "/sys/io"
+#define IOSTAT_MAX_FILES  32
+#define IOSTAT_NAME_MAX   48
+
+typedef struct {
+    uint32_t reads, writes, seeks;
+    uint32_t hits;              /* lecturas servidas sin tocar el dispositivo */
+    uint64_t rbytes, wbytes;
+    uint64_t rcycles, wcycles, scycles;
+} io_counters_t;
+
+/** @brief Acumulado de un fichero (por ruta, sobrevive a close) */
+typedef struct {
+    char          path[IOSTAT_NAME_MAX];
+    uint32_t      opens;
+    io_counters_t c;
+} iostat_file_t;
+
+extern io_counters_t iostat_dev;    /* capa diskio: bytes = sectores * 512 */
+extern io_counters_t iostat_stdio;  /* fread: hits = servidos desde el buffer */
+
+/**
+ * @brief Registro de 'path' (lo crea si no existe y cuenta una apertura)
+ *
+ * Si la tabla está llena se comparte el registro "(otros)": nunca es NULL.
+ */
+iostat_file_t* iostat_open(const char* path);
+
+static inline void iostat_read(io_counters_t* c, size_t bytes, uint64_t t0) {
+    c->reads++;
+    c->rbytes  += bytes;
+    c->rcycles += rdtsc() - t0;
+}
+
+static inline void iostat_write(io_counters_t* c, size_t bytes, uint64_t t0) {
+    c->writes++;
+    c->wbytes  += bytes;
+    c->wcycles += rdtsc() - t0;
+}
+
+static inline void iostat_seek(io_counters_t* c, uint64_t t0) {
+    c->seeks++;
+    c->scycles += rdtsc() - t0;
+}
+
+/**
+ * @brief Escribe el resumen en texto (como snprintf)
+ * @return Longitud completa del texto, aunque no quepa en 'cap'
+ */
+size_t iostat_format(char* buf, size_t cap);
+
+/** @brief Imprime el resumen por la consola */
+void iostat_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_IOSTAT_H */
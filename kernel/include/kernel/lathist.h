@@ -0,0 +1,43 @@
+/**
+ * @file lathist.h
+ * @brief Histograma de latencias con cubetas de potencias de 2 µs
+ *
+ * Las muestras se dan en ciclos del TSC y se convierten a µs al añadirlas;
+ * la cubeta i cuenta latencias en [2^(i-1), 2^i) µs (la 0, < 1 µs) y la
+ * última acumula todo lo que pase de ~1 s.
+ */
+#ifndef KERNEL_LATHIST_H
+#define KERNEL_LATHIST_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LATHIST_BUCKETS 22
+
+typedef struct {
+    const char* name;
+    uint32_t    count;
+    uint64_t    sum_us, max_us;
+    uint32_t    bucket[LATHIST_BUCKETS];
+} lathist_t;
+
+#define LATHIST_INIT(name) { (name), 0, 0, 0, { 0 } }
+
+/**
+ * @brief Añade una muestra de 'cycles' ciclos del TSC
+ */
+void lathist_add(lathist_t* h, uint64_t cycles);
+
+/**
+ * @brief Imprime resumen (n, media, p50, p99, máx) y las cubetas no vacías
+ */
+void lathist_dump(const lathist_t* h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_LATHIST_H */
@@ -0,0 +1,27 @@
+/**
+ * @file lz4.h
+ * @brief Descompresor de bloques LZ4 (formato "block", sin cabecera de frame)
+ */
+#ifndef KERNEL_LZ4_H
+#define KERNEL_LZ4_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Descomprime un bloque LZ4 completo
+ *
+ * Comprueba todos los límites: un bloque corrupto nunca escribe fuera de
+ * dst ni lee fuera de src.
+ * @return Bytes escritos en dst, o -1 si el bloque es inválido o no cabe
+ */
+int lz4_decompress(const uint8_t* src, uint32_t srclen, uint8_t* dst, uint32_t dstcap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_LZ4_H */
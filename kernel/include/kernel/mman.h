@@ -0,0 +1,47 @@
+/**
+ * @file mman.h
+ * @brief mmap()/munmap() de sólo lectura sobre ficheros (newlib no trae sys/mman.h)
+ */
+#ifndef KERNEL_MMAN_H
+#define KERNEL_MMAN_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROT_NONE    0x0
+#define PROT_READ    0x1
+#define PROT_WRITE   0x2
+#define PROT_EXEC    0x4
+
+#define MAP_SHARED   0x01
+#define MAP_PRIVATE  0x02
+#define MAP_FIXED    0x10
+
+#define MAP_FAILED   ((void*)-1)
+
+/**
+ * @brief Proyecta 'len' bytes del fichero 'fd' desde 'off' (múltiplo de 4 KiB)
+ *
+ * Sólo PROT_READ + MAP_PRIVATE. Los ficheros FatFs se cargan página a página
+ * desde el manejador de #PF; los del initrd se devuelven sin copia.
+ * No pasar punteros de un mapeo FatFs a read()/write(): el fallo de página
+ * reentraría en FatFs a mitad de otra operación. Por lo mismo, como FatFs
+ * no es reentrante, el mapeo sólo lo debe tocar el hilo que usa los
+ * ficheros FAT.
+ *
+ * Los mapeos FatFs son sólo del BSP: no se pueden leer desde tareas de
+ * kernel/task.h que corran en un AP. Un fallo de página allí es fatal, y al
+ * expulsar una página no se invalida la TLB de los AP.
+ */
+void* mmap(void* addr, size_t len, int prot, int flags, int fd, off_t off);
+int   munmap(void* addr, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_MMAN_H */
@@ -0,0 +1,108 @@
+/**
+ * @file multiboot.h
+ * @brief Acceso a la información Multiboot1 (módulos, línea de comandos, memoria)
+ */
+#ifndef KERNEL_MULTIBOOT_H
+#define KERNEL_MULTIBOOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MB_BOOTLOADER_MAGIC 0x2BADB002
+
+/* Bits de mb_info_t.flags */
+#define MB_INFO_MEMORY   (1u << 0)
+#define MB_INFO_CMDLINE  (1u << 2)
+#define MB_INFO_MODS     (1u << 3)
+#define MB_INFO_MMAP     (1u << 6)
+
+typedef struct {
+    uint32_t flags;
+    uint32_t mem_lower;     /* KiB por debajo de 1 MiB */
+    uint32_t mem_upper;     /* KiB por encima de 1 MiB */
+    uint32_t boot_device;
+    uint32_t cmdline;
+    uint32_t mods_count;
+    uint32_t mods_addr;
+    uint32_t syms[4];
+    uint32_t mmap_length;
+    uint32_t mmap_addr;
+} __attribute__((packed)) mb_info_t;
+
+typedef struct {
+    uint32_t mod_start;
+    uint32_t mod_end;
+    uint32_t string;
+    uint32_t reserved;
+} __attribute__((packed)) mb_module_t;
+
+/**
+ * @brief Módulo cargado por el bootloader (copia estable de la entrada Multiboot)
+ */
+typedef struct {
+    const void* base;       /* dirección física = virtual (identidad) */
+    uint32_t    size;
+    const char* cmdline;    /* cadena asociada (p.ej. "ramdisk") */
+} boot_module_t;
+
+#define MB_MAX_MODULES  8
+#define MB_CMDLINE_MAX  256
+
+/**
+ * @brief Copia la información Multiboot a estructuras propias
+ * @param magic Valor de EAX al entrar (debe ser MB_BOOTLOADER_MAGIC)
+ * @param info  Dirección de la estructura Multiboot (EBX al entrar)
+ * @return 0 si la información es válida, -1 si no
+ */
+int mb_init(uint32_t magic, uint32_t info);
+
+/**
+ * @brief Número de módulos cargados
+ */
+int mb_module_count(void);
+
+/**
+ * @brief Devuelve el módulo i-ésimo (NULL si no existe)
+ */
+const boot_module_t* mb_module(int i);
+
+/**
+ * @brief Busca un módulo cuya primera palabra de cmdline sea 'name'
+ * @return Puntero al módulo o NULL si no existe
+ */
+const boot_module_t* mb_find_module(const char* name);
+
+/**
+ * @brief Línea de comandos del kernel ("" si no hay)
+ */
+const char* mb_cmdline(void);
+
+/**
+ * @brief Busca una opción "clave" o "clave=valor" en la línea de comandos
+ * @return Puntero al valor (termina en ' ' o fin de cadena), "" si la
+ *         opción no lleva valor, o NULL si no aparece
+ */
+const char* mb_cmdline_opt(const char* key);
+
+/**
+ * @brief KiB de memoria alta (por encima de 1 MiB) reportada por el bootloader
+ */
+uint32_t mb_mem_upper_kb(void);
+
+/**
+ * @brief Primera dirección libre tras los módulos cargados
+ *
+ * El heap (_sbrk) debe arrancar por encima de esta dirección para no
+ * pisar los módulos que el bootloader coloca tras el kernel.
+ */
+uintptr_t mb_reserved_end(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_MULTIBOOT_H */
@@ -0,0 +1,151 @@
+/**
+ * @file ring.h
+ * @brief Cola circular SPSC sin cerrojos (un productor, un consumidor)
+ *
+ * Pensada para pasar datos de una ISR al bucle principal: el productor sólo
+ * escribe 'head' y el consumidor sólo 'tail', así que no hace falta cli.
+ * La capacidad es potencia de 2 y los índices crecen libremente (se
+ * enmascaran al acceder), de modo que head - tail es siempre el número de
+ * elementos y no se pierde un hueco para distinguir llena de vacía.
+ *
+ * El índice propio se publica con release y el ajeno se lee con acquire:
+ * en x86 son movs normales, pero impiden que el compilador adelante o
+ * retrase las copias de los elementos respecto al índice.
+ *
+ *   static kbd_event_t evq_buf[128];
+ *   static ring_t evq = RING_INIT(evq_buf, sizeof(kbd_event_t), 128);
+ */
+#ifndef KERNEL_RING_H
+#define KERNEL_RING_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint8_t* buf;
+    uint32_t esize;             /* bytes por elemento */
+    uint32_t mask;              /* capacidad - 1 */
+    uint32_t head;              /* sólo lo escribe el productor */
+    uint32_t tail;              /* sólo lo escribe el consumidor */
+    uint32_t dropped;           /* elementos rechazados por falta de sitio */
+} ring_t;
+
+/** @brief Inicializador estático; 'cap' debe ser potencia de 2 */
+#define RING_INIT(storage, esize, cap) \
+    { (uint8_t*)(storage), (esize), (cap) - 1, 0, 0, 0 }
+
+static inline uint32_t ring_load_acq(const uint32_t* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void ring_store_rel(uint32_t* p, uint32_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t ring_capacity(const ring_t* r) { return r->mask + 1; }
+
+/** @brief Elementos pendientes (vista del consumidor) */
+static inline uint32_t ring_count(const ring_t* r) {
+    return ring_load_acq(&r->head) - r->tail;
+}
+
+/** @brief Huecos libres (vista del productor) */
+static inline uint32_t ring_space(const ring_t* r) {
+    return ring_capacity(r) - (r->head - ring_load_acq(&r->tail));
+}
+
+static inline uint8_t* ring_slot(const ring_t* r, uint32_t idx) {
+    return r->buf + (size_t)(idx & r->mask) * r->esize;
+}
+
+// ---------- productor ----------
+
+/**
+ * @brief Zona contigua libre para escribir sin copia
+ * @param n Entrada: máximo deseado; salida: elementos utilizables (puede ser 0)
+ */
+static inline void* ring_reserve(ring_t* r, uint32_t* n) {
+    uint32_t space = ring_space(r);
+    uint32_t contig = ring_capacity(r) - (r->head & r->mask);
+    if (*n > space)  *n = space;
+    if (*n > contig) *n = contig;
+    return ring_slot(r, r->head);
+}
+
+/** @brief Publica 'n' elementos escritos en la zona de ring_reserve */
+static inline void ring_commit(ring_t* r, uint32_t n) {
+    ring_store_rel(&r->head, r->head + n);
+}
+
+/**
+ * @brief Encola hasta 'n' elementos (dos memcpy como mucho)
+ * @return Elementos encolados; el resto se suma a 'dropped'
+ */
+static inline uint32_t ring_write(ring_t* r, const void* src, uint32_t n) {
+    uint32_t space = ring_space(r);
+    uint32_t done = n < space ? n : space;
+    uint32_t first = ring_capacity(r) - (r->head & r->mask);
+    if (first > done) first = done;
+    memcpy(ring_slot(r, r->head), src, (size_t)first * r->esize);
+    memcpy(r->buf, (const uint8_t*)src + (size_t)first * r->esize, (size_t)(done - first) * r->esize);
+    r->dropped += n - done;
+    ring_commit(r, done);
+    return done;
+}
+
+/** @brief Encola un elemento; 0 si cupo, -1 si estaba llena */
+static inline int ring_push(ring_t* r, const void* e) {
+    if (ring_space(r) == 0) { r->dropped++; return -1; }
+    memcpy(ring_slot(r, r->head), e, r->esize);
+    ring_commit(r, 1);
+    return 0;
+}
+
+// ---------- consumidor ----------
+
+/**
+ * @brief Zona contigua con datos para leer sin copia
+ * @param n Entrada: máximo deseado; salida: elementos disponibles (puede ser 0)
+ */
+static inline const void* ring_peek(ring_t* r, uint32_t* n) {
+    uint32_t count = ring_count(r);
+    uint32_t contig = ring_capacity(r) - (r->tail & r->mask);
+    if (*n > count)  *n = count;
+    if (*n > contig) *n = contig;
+    return ring_slot(r, r->tail);
+}
+
+/** @brief Libera 'n' elementos ya leídos con ring_peek */
+static inline void ring_consume(ring_t* r, uint32_t n) {
+    ring_store_rel(&r->tail, r->tail + n);
+}
+
+/** @brief Desencola hasta 'n' elementos; devuelve cuántos */
+static inline uint32_t ring_read(ring_t* r, void* dst, uint32_t n) {
+    uint32_t count = ring_count(r);
+    uint32_t done = n < count ? n : count;
+    uint32_t first = ring_capacity(r) - (r->tail & r->mask);
+    if (first > done) first = done;
+    memcpy(dst, ring_slot(r, r->tail), (size_t)first * r->esize);
+    memcpy((uint8_t*)dst + (size_t)first * r->esize, r->buf, (size_t)(done - first) * r->esize);
+    ring_consume(r, done);
+    return done;
+}
+
+/** @brief Desencola un elemento; 0 si había, -1 si estaba vacía */
+static inline int ring_pop(ring_t* r, void* e) {
+    if (ring_count(r) == 0) return -1;
+    memcpy(e, ring_slot(r, r->tail), r->esize);
+    ring_consume(r, 1);
+    return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_RING_H */
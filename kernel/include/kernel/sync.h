@@ -0,0 +1,73 @@
+/**
+ * @file sync.h
+ * @brief Mutex, semáforos y variables de condición para hilos del kernel
+ *
+ * Los hilos sólo corren en el BSP: las secciones críticas internas son
+ * cli/sti y los hilos que esperan se bloquean en una waitq_t. Los mutex
+ * llevan además un spinlock y valen también en los AP (tareas de
+ * kernel/task.h), que esperan girando; de ahí que malloc y stdio se puedan
+ * usar desde una tarea. Semáforos y variables de condición son sólo del
+ * BSP: desde un AP avisan por consola y no hacen nada.
+ * Antes de thread_init() todas las operaciones vuelven en el acto, así que
+ * el código que las usa funciona igual sin hilos.
+ *
+ * Desde una ISR sólo se puede usar semaphore_post(); el hilo despertado
+ * entra en la CPU en el siguiente tic.
+ */
+#ifndef KERNEL_SYNC_H
+#define KERNEL_SYNC_H
+
+#include <kernel/thread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const void*      owner;                 /* thread_t* del BSP o cpu_t* de un AP */
+    uint32_t         depth;                 /* tomas anidadas del dueño */
+    uint8_t          recursive;
+    uint8_t          owner_ap;              /* el dueño es un AP: se espera girando */
+    volatile uint8_t lock;                  /* spinlock de owner/depth entre CPUs */
+    waitq_t          waiters;               /* sólo hilos del BSP */
+} mutex_t;
+
+#define MUTEX_INIT              { NULL, 0, 0, 0, 0, WAITQ_INIT }
+#define MUTEX_INIT_RECURSIVE    { NULL, 0, 1, 0, 0, WAITQ_INIT }
+
+typedef struct {
+    int     count;
+    waitq_t waiters;
+} semaphore_t;
+
+#define SEMAPHORE_INIT(n)       { (n), WAITQ_INIT }
+
+typedef struct {
+    waitq_t waiters;
+} condvar_t;
+
+#define CONDVAR_INIT            { WAITQ_INIT }
+
+void mutex_init(mutex_t* m, int recursive);
+void mutex_lock(mutex_t* m);
+/** @return 1 si lo ha tomado, 0 si tiene otro dueño */
+int  mutex_trylock(mutex_t* m);
+void mutex_unlock(mutex_t* m);
+
+void semaphore_init(semaphore_t* s, int count);
+void semaphore_wait(semaphore_t* s);
+/** @return 1 si ha decrementado, 0 si el contador estaba a 0 */
+int  semaphore_trywait(semaphore_t* s);
+void semaphore_post(semaphore_t* s);
+
+void condvar_init(condvar_t* c);
+/** @brief Suelta 'm', espera un aviso y vuelve con 'm' tomado (sin anidar) */
+void condvar_wait(condvar_t* c, mutex_t* m);
+void condvar_signal(condvar_t* c);
+void condvar_broadcast(condvar_t* c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_SYNC_H */
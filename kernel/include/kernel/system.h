@@ -29,6 +29,22 @@ static inline void disable_interrupts(void) {
     __asm__ __volatile__("cli");
 }
 
+/**
+ * @brief Deshabilita las interrupciones y devuelve EFLAGS previo
+ */
+static inline unsigned long irq_save(void) {
+    unsigned long flags;
+    __asm__ __volatile__("pushf\n\tpop %0\n\tcli" : "=r"(flags) :: "memory");
+    return flags;
+}
+
+/**
+ * @brief Restaura IF tal como estaba en irq_save()
+ */
+static inline void irq_restore(unsigned long flags) {
+    if (flags & 0x200) __asm__ __volatile__("sti" ::: "memory");
+}
+
 /**
  * @brief Espera hasta la siguiente interrupción
  */
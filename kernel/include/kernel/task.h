@@ -0,0 +1,81 @@
+/**
+ * @file task.h
+ * @brief Tareas fork-join repartidas entre CPUs por robo de trabajo
+ *
+ * Cada CPU tiene una deque de Chase-Lev: su dueño apila y desapila por
+ * abajo (LIFO, caché caliente) y las demás CPUs roban por arriba eligiendo
+ * víctima al azar. Los AP, tras task_init(), no hacen otra cosa: buscan
+ * trabajo un rato y, si no lo hay, se duermen en hlt hasta que un
+ * task_spawn() les manda una IPI.
+ *
+ * El task_t lo aporta el llamante (normalmente en su pila) y debe seguir
+ * vivo hasta task_wait(); así ni el reparto ni los AP tocan malloc.
+ * task_wait() no se queda parado: mientras espera ejecuta tareas propias o
+ * robadas. No se puede usar desde una ISR. Varios hilos del BSP pueden
+ * usarlo a la vez: comparten la deque del BSP, cuyas operaciones de dueño
+ * se hacen con las interrupciones desactivadas.
+ *
+ * Una tarea puede acabar en cualquier CPU. Los mutex de kernel/sync.h, y
+ * con ellos los cerrojos de newlib (malloc, stdio), funcionan en los AP
+ * esperando con espera activa; semáforos y variables de condición no: desde
+ * un AP se ignoran con un aviso. Si la tarea esperada la está ejecutando un
+ * hilo del BSP de menor prioridad, task_wait() le acaba cediendo la CPU.
+ *
+ * Con una sola CPU (o antes de task_init) todo se ejecuta en el sitio, así
+ * que el código de Doom puede llamarlo siempre:
+ *
+ *   static void fill(void* ctx, int lo, int hi) { ... filas lo..hi-1 ... }
+ *   parallel_for(0, SCREENHEIGHT, 8, fill, ctx);
+ */
+#ifndef KERNEL_TASK_H
+#define KERNEL_TASK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TASK_DEQUE_SIZE 256     /* potencia de 2; si se llena, la tarea se ejecuta en el sitio */
+
+typedef void (*task_fn_t)(void* arg);
+typedef void (*task_range_fn_t)(void* ctx, int lo, int hi);
+
+typedef struct task {
+    task_fn_t         fn;
+    void*             arg;
+    volatile uint32_t done;
+} task_t;
+
+/**
+ * @brief Pone a los AP a ejecutar tareas (después de smp_init)
+ * @return Nº de CPUs que ejecutan tareas, incluida la actual
+ */
+int task_init(void);
+
+/** @brief CPUs que ejecutan tareas (1 si no hay AP o antes de task_init) */
+int task_workers(void);
+
+/**
+ * @brief Encola fn(arg) para que la ejecute cualquier CPU
+ * @param t Almacenamiento de la tarea; no se puede reutilizar hasta task_wait
+ */
+void task_spawn(task_t* t, task_fn_t fn, void* arg);
+
+/** @brief Espera a que 't' termine, ejecutando otras tareas mientras tanto */
+void task_wait(task_t* t);
+
+/**
+ * @brief Ejecuta fn(ctx, lo, hi) sobre [begin, end) troceado en rangos de ~grain
+ *
+ * Divide el rango por mitades (la mitad alta queda disponible para robo)
+ * hasta que cada trozo tiene como mucho 'grain' elementos. Vuelve cuando
+ * todos los trozos han terminado.
+ */
+void parallel_for(int begin, int end, int grain, task_range_fn_t fn, void* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_TASK_H */
@@ -0,0 +1,161 @@
+/**
+ * @file thread.h
+ * @brief Hilos del kernel con planificador expropiativo por prioridades
+ *
+ * Sólo en el BSP: los AP ejecutan tareas (kernel/task.h) y nunca hilos, ni
+ * tocan las colas de espera (kernel/sync.h decide cómo espera un AP).
+ * thread_init() convierte el flujo que llama (kernel_main → main) en el hilo
+ * "main". Cada prioridad tiene su cola FIFO y siempre se ejecuta el primer
+ * hilo listo de la más alta; dentro de una prioridad se reparte por turnos
+ * de THREAD_SLICE_TICKS tics del PIT. El tic de IRQ0 despierta a los hilos
+ * dormidos y expropia al actual cuando agota su turno.
+ *
+ * Las colas de espera (waitq_t) son la base de mutex, semáforos y variables
+ * de condición (kernel/sync.h). Sus funciones se llaman con IF=0.
+ *
+ * El estado x87/SSE se cambia de forma perezosa: al cambiar de hilo sólo se
+ * pone CR0.TS, y el FXSAVE/FXRSTOR se hace en el #NM del primer uso, si el
+ * dueño de la FPU es otro hilo. Las ISR no deben usar x87/SSE.
+ */
+#ifndef KERNEL_THREAD_H
+#define KERNEL_THREAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define THREAD_PRIOS          4             /* 0 = la más alta */
+#define THREAD_PRIO_DEFAULT   2
+#define THREAD_STACK_DEFAULT  (16 * 1024)
+#define THREAD_SLICE_TICKS    2             /* 20 ms a 100 Hz */
+
+typedef void (*thread_fn_t)(void* arg);
+
+typedef enum {
+    THREAD_READY,
+    THREAD_RUNNING,
+    THREAD_BLOCKED,
+    THREAD_SLEEPING,
+    THREAD_DEAD,
+} thread_state_t;
+
+struct thread;
+
+typedef struct {
+    struct thread* head;
+    struct thread* tail;
+} waitq_t;
+
+#define WAITQ_INIT { NULL, NULL }
+
+typedef struct thread {
+    uint32_t        esp;                    /* lo guarda thread_switch (switch.S) */
+    struct thread*  next;                   /* cola de listos, de espera o de dormidos */
+    uint32_t        id;
+    const char*     name;
+    uint8_t         prio;
+    uint8_t         state;                  /* thread_state_t */
+    uint8_t         slice;                  /* tics que quedan del turno */
+    uint32_t        wake_tick;
+    uint8_t*        stack;                  /* NULL en main e idle */
+    thread_fn_t     fn;
+    void*           arg;
+    waitq_t         joiners;
+    uint32_t        switches;               /* veces que ha entrado en la CPU */
+    uint8_t         fpu_saved;              /* fpu[] guarda su estado x87/SSE */
+    uint8_t         fpu[512] __attribute__((aligned(16)));     /* área FXSAVE */
+} thread_t;
+
+typedef struct {
+    uint32_t switches;                      /* cambios de hilo */
+    uint32_t traps;                         /* #NM atendidos */
+    uint32_t saves;                         /* FXSAVE hechos */
+    uint32_t restores;                      /* FXRSTOR hechos */
+} thread_fpu_stats_t;
+
+/**
+ * @brief Convierte el flujo actual en el hilo "main" y arranca el planificador
+ *
+ * Llamar una vez, con el PIT ya programado y sin cerrojos de newlib tomados.
+ */
+void thread_init(void);
+
+/**
+ * @brief Crea un hilo listo para ejecutarse
+ * @param prio 0..THREAD_PRIOS-1 (fuera de rango: THREAD_PRIO_DEFAULT)
+ * @param stack_size Bytes de pila (0: THREAD_STACK_DEFAULT)
+ * @return El hilo, o NULL sin memoria o antes de thread_init
+ */
+thread_t* thread_create(const char* name, thread_fn_t fn, void* arg, int prio, size_t stack_size);
+
+/** @brief Termina el hilo actual (también al volver de su función) */
+void thread_exit(void) __attribute__((noreturn));
+
+/** @brief Espera a que 't' termine y libera su pila */
+void thread_join(thread_t* t);
+
+/** @brief Hilo en ejecución (NULL antes de thread_init) */
+thread_t* thread_current(void);
+
+/** @brief Hilos vivos, sin contar el de idle (0 antes de thread_init) */
+int thread_count(void);
+
+/**
+ * @brief Cede la CPU a otro hilo listo de igual o mayor prioridad
+ * @return 1 si llegó a ejecutarse otro hilo
+ */
+int thread_yield(void);
+
+/** @brief Duerme al menos 'ms' milisegundos (redondeado a tics del PIT) */
+void thread_sleep_ms(uint32_t ms);
+
+/**
+ * @brief Si hay otros hilos listos, cede la CPU hasta el siguiente tic
+ *        (también a los de menor prioridad)
+ * @return 1 si ha cedido, 0 si no había ningún otro hilo listo
+ */
+int thread_yield_any(void);
+
+/** @brief Espera de idle: thread_yield_any() o, si no hay nadie listo, hlt */
+void thread_idle_wait(void);
+
+/** @brief Llamada desde la ISR del PIT, ya enviado el EOI */
+void sched_tick(void);
+
+/**
+ * @brief #NM (dispositivo no disponible): da la FPU al hilo actual
+ * @return 1 si era un #NM por CR0.TS y se ha atendido; 0 si es un fallo real
+ */
+int thread_handle_nm(void);
+
+/** @brief Contadores del cambio de FPU perezoso (ahorro = switches - saves) */
+const thread_fpu_stats_t* thread_fpu_stats(void);
+
+/** @brief Imprime thread_fpu_stats() */
+void thread_fpu_dump(void);
+
+/* ---- colas de espera (IF=0) ---- */
+
+/** @brief Bloquea el hilo actual en 'q' hasta un waitq_wake_* */
+void waitq_wait(waitq_t* q);
+
+/** @brief Despierta al primero de 'q'; 1 si había alguno */
+int waitq_wake_one(waitq_t* q);
+
+/** @brief Despierta a todos los de 'q'; devuelve cuántos */
+int waitq_wake_all(waitq_t* q);
+
+/**
+ * @brief Si un despertar ha dejado listo un hilo más prioritario, cede la CPU
+ * @param flags Valor de irq_save(): si IF estaba a 0 (ISR), espera al tic
+ */
+void sched_preempt_check(unsigned long flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_THREAD_H */
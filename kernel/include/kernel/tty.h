@@ -0,0 +1,50 @@
+/**
+ * @file tty.h
+ * @brief /dev/tty: consola (salida) y teclado (entrada) con modo raw/cooked
+ */
+#ifndef KERNEL_TTY_H
+#define KERNEL_TTY_H
+
+#include <kernel/vfs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Constructor del nodo /dev/tty (ver VFS_DEV_NODES)
+ */
+int tty_open(vfs_file_t* f, int oflag);
+
+/* Flags de tty_termios_t.lflag */
+#define TTY_ICANON  0x01    /* edición de línea: read devuelve al llegar '\n' */
+#define TTY_ECHO    0x02    /* eco de lo tecleado */
+#define TTY_ICRNL   0x04    /* CR → LF en la entrada (sólo canónico) */
+
+#define TTY_LINE_DEFAULT 256
+
+/**
+ * @brief Atributos de la disciplina de línea (subconjunto de termios)
+ */
+typedef struct {
+    uint32_t lflag;         /* TTY_* */
+    uint32_t line_max;      /* bytes del buffer de línea, '\n' incluido (≥ 2) */
+} tty_termios_t;
+
+/**
+ * @brief Copia los atributos actuales
+ */
+void tty_getattr(tty_termios_t* t);
+
+/**
+ * @brief Cambia los atributos. El buffer de línea sólo se redimensiona si
+ *        no hay una línea a medio editar o por entregar.
+ * @return 0 si ok; -1 con errno EINVAL (line_max < 2), EBUSY o ENOMEM
+ */
+int tty_setattr(const tty_termios_t* t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_TTY_H */
@@ -0,0 +1,39 @@
+/**
+ * @file uio.h
+ * @brief E/S vectorial y posicional (newlib no trae sys/uio.h)
+ */
+#ifndef KERNEL_UIO_H
+#define KERNEL_UIO_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IOV_MAX 1024
+
+struct iovec {
+    void*  iov_base;
+    size_t iov_len;
+};
+
+/**
+ * @brief Lee en varios buffers consecutivos con una sola llamada
+ * @return Bytes leídos en total (se para en la primera lectura corta)
+ */
+ssize_t readv(int fd, const struct iovec* iov, int iovcnt);
+
+/**
+ * @brief Escribe varios buffers consecutivos con una sola llamada
+ */
+ssize_t writev(int fd, const struct iovec* iov, int iovcnt);
+
+/* pread()/pwrite() ya están declaradas en <unistd.h> de newlib */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_UIO_H */
@@ -0,0 +1,121 @@
+/**
+ * @file vfs.h
+ * @brief Capa VFS: puntos de montaje, ficheros abiertos con sus ops y tabla de fds
+ *
+ * Cada sistema de ficheros aporta un vfs_fs_ops_t y se monta bajo un
+ * prefijo ("/initrd", "/dev", "/sys"; "" es la raíz, FatFs). Abrir una
+ * ruta elige el montaje de prefijo más largo y el backend rellena un
+ * vfs_file_t con sus vfs_file_ops_t; a partir de ahí las syscalls sólo
+ * llaman a esas ops. Los fds 0/1/2 son /dev/tty abiertos en vfs_init().
+ */
+#ifndef KERNEL_VFS_H
+#define KERNEL_VFS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <kernel/iostat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VFS_MAX_MOUNTS  8
+#define VFS_FD_INIT_CAP 16
+#define VFS_FD_MAX      1024
+
+typedef struct vfs_file vfs_file_t;
+
+/**
+ * @brief Operaciones de un fichero abierto
+ *
+ * Una op a NULL da el error típico: read/write → EBADF, lseek/pread/pwrite
+ * → ESPIPE, mmap → ENODEV; fsync y close a NULL no hacen nada. fstat es
+ * obligatoria. Todas devuelven -1 y fijan errno si fallan.
+ */
+typedef struct {
+    ssize_t (*read)(vfs_file_t* f, void* buf, size_t n);
+    ssize_t (*write)(vfs_file_t* f, const void* buf, size_t n);
+    off_t   (*lseek)(vfs_file_t* f, off_t off, int whence);
+    ssize_t (*pread)(vfs_file_t* f, void* buf, size_t n, off_t off);
+    ssize_t (*pwrite)(vfs_file_t* f, const void* buf, size_t n, off_t off);
+    int     (*fstat)(vfs_file_t* f, struct stat* st);
+    int     (*fsync)(vfs_file_t* f);
+    void*   (*mmap)(vfs_file_t* f, size_t len, off_t off);   /* NULL + errno si falla */
+    int     (*close)(vfs_file_t* f);
+} vfs_file_ops_t;
+
+struct vfs_file {
+    const vfs_file_ops_t* ops;
+    void*          priv;    /* estado del backend */
+    int            oflag;   /* flags O_* de la apertura */
+    iostat_file_t* io;      /* contadores de la ruta (ver iostat.h) */
+};
+
+/**
+ * @brief Operaciones de un sistema de ficheros montado
+ *
+ * 'path' llega relativo al punto de montaje (sin la barra inicial), salvo
+ * en la raíz, que recibe la ruta tal cual. Sólo open es obligatoria.
+ */
+typedef struct {
+    int (*open)(void* ctx, const char* path, int oflag, vfs_file_t* f);
+    int (*unlink)(void* ctx, const char* path);
+    int (*rename)(void* ctx, const char* oldp, const char* newp);
+    int (*mkdir)(void* ctx, const char* path, mode_t mode);
+} vfs_fs_ops_t;
+
+/* Backends incluidos */
+extern const vfs_fs_ops_t VFS_FATFS;    /* FatFs sobre el disco RAM (raíz) */
+extern const vfs_fs_ops_t VFS_INITRD;   /* CPIO del initrd, sin copia */
+extern const vfs_fs_ops_t VFS_NODES;    /* nodos fijos (ctx = vfs_node_t[]) */
+
+/**
+ * @brief Nodo de VFS_NODES: nombre y constructor del fichero abierto
+ */
+typedef struct {
+    const char* name;
+    int (*open)(vfs_file_t* f, int oflag);
+} vfs_node_t;
+
+extern const vfs_node_t VFS_DEV_NODES[];    /* tty, fb0, serial */
+extern const vfs_node_t VFS_SYS_NODES[];    /* io */
+
+/**
+ * @brief Monta 'ops' bajo 'prefix' ("" = raíz; sin barra final)
+ * @return 0 si ok, -1 si no quedan puntos de montaje
+ */
+int vfs_mount(const char* prefix, const vfs_fs_ops_t* ops, void* ctx);
+
+/**
+ * @brief Monta los backends por defecto y abre /dev/tty como fds 0, 1 y 2
+ */
+void vfs_init(void);
+
+/**
+ * @brief Fichero en memoria de sólo lectura (initrd, /sys/io)
+ * @param owned si es 1, 'data' se libera con free() al cerrar
+ */
+int vfs_memfile(vfs_file_t* f, const void* data, uint32_t size, int owned);
+
+/* Tabla de fds */
+int         vfs_open(const char* path, int oflag);
+vfs_file_t* vfs_fd(int fd);                 /* NULL si el fd no está abierto */
+int         vfs_close(int fd);
+
+/**
+ * @brief fsync de todos los ficheros abiertos (antes de apagar)
+ */
+void vfs_sync(void);
+
+/* Operaciones por ruta */
+int vfs_unlink(const char* path);
+int vfs_rename(const char* oldp, const char* newp);
+int vfs_mkdir(const char* path, mode_t mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_VFS_H */
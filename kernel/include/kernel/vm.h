@@ -0,0 +1,53 @@
+/**
+ * @file vm.h
+ * @brief Mapeos de ficheros FatFs paginados bajo demanda
+ */
+#ifndef KERNEL_VM_H
+#define KERNEL_VM_H
+
+#include <stdint.h>
+#include <fatfs/ff.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VM_MAX_MAPPINGS   16
+#define VM_MAX_FRAMES     2048      /* páginas residentes como máximo (8 MiB) */
+
+typedef struct {
+    uint32_t faults;        /* #PF atendidos */
+    uint32_t evictions;     /* páginas limpias expulsadas por el reloj */
+    uint32_t resident;      /* páginas residentes ahora mismo */
+    uint32_t mappings;      /* mapeos activos */
+} vm_stats_t;
+
+/**
+ * @brief Reserva espacio virtual para [off, off+len) del fichero 'src'
+ *
+ * Se usa una copia privada del FIL (posición propia), así que el fd
+ * original puede seguir usándose o cerrarse. Los marcos del pool (hasta
+ * VM_MAX_FRAMES entre todos los mapeos) se reservan aquí, no en el #PF.
+ * @return Dirección base del mapeo o NULL (errno)
+ */
+void* vm_map_file(const FIL* src, uint32_t off, uint32_t len);
+
+/**
+ * @brief Deshace un mapeo creado con vm_map_file (addr debe ser su base)
+ * @return 0 si ok, -1 si no existe
+ */
+int vm_unmap(void* addr);
+
+/**
+ * @brief Atiende un #PF dentro de la ventana de mapeos
+ * @return 1 si se resolvió (reintentar la instrucción), 0 si no es nuestro
+ */
+int vm_handle_fault(uint32_t va, uint32_t err);
+
+void vm_get_stats(vm_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KERNEL_VM_H */
@@ -0,0 +1,36 @@
+/**
+ * @file wadlz4.h
+ * @brief Formato de WAD comprimido (tools/wadlz4.c lo genera)
+ *
+ * El fichero describe el WAD original como una lista de extensiones
+ * ordenadas por vpos: cabecera, cada lump y el directorio. Cada extensión
+ * se guarda comprimida con LZ4 (bloque) o tal cual si csize == vsize. Los
+ * huecos entre extensiones se leen como ceros. Todo en little-endian.
+ *
+ *   wadlz4_header_t
+ *   wadlz4_extent_t[nextents]
+ *   datos
+ */
+#ifndef KERNEL_WADLZ4_H
+#define KERNEL_WADLZ4_H
+
+#include <stdint.h>
+
+#define WADLZ4_MAGIC    "LZ4W"
+#define WADLZ4_VERSION  1
+
+typedef struct {
+    char     magic[4];      /* WADLZ4_MAGIC */
+    uint32_t version;
+    uint32_t vsize;         /* tamaño del WAD original */
+    uint32_t nextents;
+} __attribute__((packed)) wadlz4_header_t;
+
+typedef struct {
+    uint32_t vpos;          /* offset en el WAD original */
+    uint32_t vsize;
+    uint32_t cpos;          /* offset en este fichero */
+    uint32_t csize;         /* == vsize: sin comprimir */
+} __attribute__((packed)) wadlz4_extent_t;
+
+#endif /* KERNEL_WADLZ4_H */
@@ -0,0 +1,189 @@
+/**
+ * @file acpi.c
+ * @brief isa-debug-exit, apagado ACPI S5 y lista de CPUs (MADT) sin intérprete AML
+ *
+ * Sólo se recorren RSDP → RSDT → FADT y se busca el paquete \_S5 en el
+ * DSDT con el patrón habitual (NameOp "_S5_" PackageOp). Las tablas están
+ * en RAM por debajo de VM_WINDOW_BASE, cubierta por la identidad de paging.c.
+ */
+#include <arch/x86/acpi.h>
+#include <arch/x86/bios.h>
+#include <arch/x86/io.h>
+#include <arch/x86/paging.h>
+#include <stddef.h>
+#include <string.h>
+
+typedef struct __attribute__((packed)) {
+    char     sig[8];                // "RSD PTR "
+    uint8_t  checksum;
+    char     oem[6];
+    uint8_t  revision;
+    uint32_t rsdt;
+} acpi_rsdp_t;
+
+typedef struct __attribute__((packed)) {
+    char     sig[4];
+    uint32_t length;
+    uint8_t  revision;
+    uint8_t  checksum;
+    char     oem[6];
+    char     oem_table[8];
+    uint32_t oem_rev;
+    uint32_t creator;
+    uint32_t creator_rev;
+} acpi_sdt_t;
+
+// FADT (ACPI 1.0) hasta PM1b_CNT_BLK
+typedef struct __attribute__((packed)) {
+    acpi_sdt_t h;
+    uint32_t firmware_ctrl;
+    uint32_t dsdt;
+    uint8_t  reserved;
+    uint8_t  pm_profile;
+    uint16_t sci_int;
+    uint32_t smi_cmd;
+    uint8_t  acpi_enable;
+    uint8_t  acpi_disable;
+    uint8_t  s4bios_req;
+    uint8_t  pstate_cnt;
+    uint32_t pm1a_evt;
+    uint32_t pm1b_evt;
+    uint32_t pm1a_cnt;
+    uint32_t pm1b_cnt;
+} acpi_fadt_t;
+
+typedef struct __attribute__((packed)) {
+    acpi_sdt_t h;
+    uint32_t lapic_addr;
+    uint32_t flags;
+} acpi_madt_t;
+
+#define MADT_LAPIC          0   // entrada: acpi_id, apic_id, flags
+#define MADT_LAPIC_OVERRIDE 5   // dirección de 64 bits del LAPIC
+#define MADT_LAPIC_ENABLED  0x1
+
+#define PM1_SCI_EN   0x0001
+#define PM1_SLP_EN   0x2000
+#define PM1_SLP_TYP  10         // desplazamiento de SLP_TYPx
+
+#define AML_NAME     0x08
+#define AML_ROOT     0x5C       // '\'
+#define AML_PACKAGE  0x12
+#define AML_BYTE     0x0A
+
+void qemu_debug_exit(uint16_t port, uint32_t status) {
+    outl(port, status);
+}
+
+static int table_ok(uint32_t addr) {
+    if (!addr || addr >= VM_WINDOW_BASE) return 0;
+    const acpi_sdt_t* t = (const acpi_sdt_t*)addr;
+    return t->length >= sizeof(acpi_sdt_t) && t->length < VM_WINDOW_BASE - addr &&
+           bios_checksum_ok(t, t->length);
+}
+
+static const acpi_rsdp_t* rsdp_scan(uint32_t base, uint32_t len) {
+    for (uint32_t a = base; a + sizeof(acpi_rsdp_t) <= base + len; a += 16) {
+        const acpi_rsdp_t* r = (const acpi_rsdp_t*)a;
+        if (memcmp(r->sig, "RSD PTR ", 8) == 0 && bios_checksum_ok(r, sizeof(*r))) return r;
+    }
+    return NULL;
+}
+
+// Tabla con firma 'sig' en la RSDT, o NULL
+static const acpi_sdt_t* acpi_find(const char* sig) {
+    uint32_t ebda = bios_ebda_base();
+    const acpi_rsdp_t* rsdp = ebda ? rsdp_scan(ebda, 1024) : NULL;
+    if (!rsdp) rsdp = rsdp_scan(0xE0000, 0x20000);
+    if (!rsdp || !table_ok(rsdp->rsdt)) return NULL;
+
+    const acpi_sdt_t* rsdt = (const acpi_sdt_t*)rsdp->rsdt;
+    const uint32_t* ent = (const uint32_t*)(rsdt + 1);
+    uint32_t n = (rsdt->length - sizeof(acpi_sdt_t)) / 4;
+    for (uint32_t i = 0; i < n; i++) {
+        const acpi_sdt_t* t = (const acpi_sdt_t*)ent[i];
+        if (table_ok(ent[i]) && memcmp(t->sig, sig, 4) == 0) return t;
+    }
+    return NULL;
+}
+
+static const acpi_fadt_t* find_fadt(void) {
+    const acpi_sdt_t* t = acpi_find("FACP");
+    return (t && t->length >= sizeof(acpi_fadt_t)) ? (const acpi_fadt_t*)t : NULL;
+}
+
+int acpi_madt_lapics(uint8_t* apic_ids, int max, uint32_t* lapic_base) {
+    const acpi_sdt_t* t = acpi_find("APIC");
+    if (!t || t->length < sizeof(acpi_madt_t)) return -1;
+    const acpi_madt_t* madt = (const acpi_madt_t*)t;
+    *lapic_base = madt->lapic_addr;
+
+    int n = 0;
+    const uint8_t* p   = (const uint8_t*)(madt + 1);
+    const uint8_t* end = (const uint8_t*)t + t->length;
+    while (p + 2 <= end && p[1] >= 2 && p + p[1] <= end) {
+        if (p[0] == MADT_LAPIC && p[1] >= 8) {
+            uint32_t flags = p[4] | p[5] << 8 | p[6] << 16 | (uint32_t)p[7] << 24;
+            if ((flags & MADT_LAPIC_ENABLED) && n < max) apic_ids[n++] = p[3];
+        } else if (p[0] == MADT_LAPIC_OVERRIDE && p[1] >= 12) {
+            uint32_t lo = p[4] | p[5] << 8 | p[6] << 16 | (uint32_t)p[7] << 24;
+            uint32_t hi = p[8] | p[9] << 8 | p[10] << 16 | (uint32_t)p[11] << 24;
+            if (!hi) *lapic_base = lo;              // por encima de 4 GiB no es alcanzable
+        }
+        p += p[1];
+    }
+    return n;
+}
+
+// Lee un entero pequeño AML (ZeroOp, OneOp o BytePrefix n)
+static const uint8_t* aml_small_int(const uint8_t* p, const uint8_t* end, uint16_t* v) {
+    if (p >= end) return NULL;
+    if (*p == AML_BYTE) { if (p + 1 >= end) return NULL; *v = p[1]; return p + 2; }
+    *v = *p;
+    return p + 1;
+}
+
+static int find_s5(uint32_t dsdt, uint16_t* typa, uint16_t* typb) {
+    if (!table_ok(dsdt)) return -1;
+    const uint8_t* p   = (const uint8_t*)dsdt + sizeof(acpi_sdt_t);
+    const uint8_t* end = (const uint8_t*)dsdt + ((const acpi_sdt_t*)dsdt)->length;
+
+    for (; p + 4 < end; p++) {
+        if (memcmp(p, "_S5_", 4) != 0) continue;
+        int named = p[-1] == AML_NAME || (p[-1] == AML_ROOT && p[-2] == AML_NAME);
+        if (!named || p[4] != AML_PACKAGE) continue;
+
+        const uint8_t* q = p + 5;
+        q += 1 + (*q >> 6);             // PkgLength: bits 7..6 = bytes extra
+        q += 1;                         // NumElements
+        if (!(q = aml_small_int(q, end, typa))) return -1;
+        if (!aml_small_int(q, end, typb)) return -1;
+        return 0;
+    }
+    return -1;
+}
+
+static void acpi_s5(void) {
+    const acpi_fadt_t* fadt = find_fadt();
+    uint16_t typa, typb;
+    if (!fadt || !fadt->pm1a_cnt || find_s5(fadt->dsdt, &typa, &typb) < 0) return;
+
+    uint16_t pm1a = (uint16_t)fadt->pm1a_cnt;
+    if (!(inw(pm1a) & PM1_SCI_EN) && fadt->smi_cmd && fadt->acpi_enable) {
+        outb((uint16_t)fadt->smi_cmd, fadt->acpi_enable);
+        for (uint32_t i = 0; i < 1000000 && !(inw(pm1a) & PM1_SCI_EN); i++) { }
+    }
+
+    outw(pm1a, (uint16_t)((typa << PM1_SLP_TYP) | PM1_SLP_EN));
+    if (fadt->pm1b_cnt)
+        outw((uint16_t)fadt->pm1b_cnt, (uint16_t)((typb << PM1_SLP_TYP) | PM1_SLP_EN));
+}
+
+int acpi_poweroff(void) {
+    acpi_s5();
+    // Puertos fijos conocidos: QEMU (q35/piix ≥ 2.0), Bochs/QEMU antiguo, VirtualBox
+    outw(0x604, 0x2000);
+    outw(0xB004, 0x2000);
+    outw(0x4004, 0x3400);
+    return -1;
+}
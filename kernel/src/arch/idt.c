@@ -20,6 +20,12 @@ static void lidt(void *idtr){
     __asm__ volatile("lidtl (%0)" :: "r"(idtr));
 }
 
+/* La IDT es compartida: los AP sólo necesitan cargarla */
+void idt_load(void){
+    struct idt_ptr idtr = { .limit = sizeof(idt)-1, .base = (uint32_t)idt };
+    lidt(&idtr);
+}
+
 static inline uint16_t read_cs(void){
     uint16_t cs; __asm__ volatile ("mov %%cs,%0" : "=r"(cs));
     return cs;
@@ -61,9 +67,13 @@ void interrupts_init(void){
     /* IRQs que sí usamos */
     idt_set_gate(0x20, (uint32_t)irq0_stub,  cs, 0x8E); // PIT
     idt_set_gate(0x21, (uint32_t)irq1_stub,  cs, 0x8E); // KBD
+    idt_set_gate(0x2C, (uint32_t)irq12_stub, cs, 0x8E); // ratón (se desenmascara en mouse_init)
 
-    struct idt_ptr idtr = { .limit = sizeof(idt)-1, .base = (uint32_t)idt };
-    lidt(&idtr);
+    /* APIC local (SMP) */
+    idt_set_gate(0xF0, (uint32_t)ipi_stub,      cs, 0x8E); // IPI_WAKEUP_VEC
+    idt_set_gate(0xFF, (uint32_t)spurious_stub, cs, 0x8E); // LAPIC_SPURIOUS_VEC
+
+    idt_load();
 
     pic_unmask(0);   // timer
     pic_unmask(1);   // teclado
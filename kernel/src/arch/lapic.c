@@ -0,0 +1,60 @@
+/**
+ * @file lapic.c
+ * @brief Implementación del APIC local (registros MMIO, identidad de paging.c)
+ */
+#include <arch/x86/lapic.h>
+
+#define LAPIC_ID        0x020
+#define LAPIC_TPR       0x080
+#define LAPIC_EOI       0x0B0
+#define LAPIC_SVR       0x0F0
+#define LAPIC_ICR_LO    0x300
+#define LAPIC_ICR_HI    0x310
+
+#define SVR_ENABLE      0x100
+#define ICR_PENDING     (1u << 12)
+#define ICR_LEVEL_ASSERT (1u << 14)
+#define ICR_FIXED       0x000
+#define ICR_INIT        0x500
+#define ICR_STARTUP     0x600
+
+static volatile uint8_t* g_lapic = (volatile uint8_t*)LAPIC_DEFAULT_BASE;
+
+static inline uint32_t rd(uint32_t reg) { return *(volatile uint32_t*)(g_lapic + reg); }
+static inline void wr(uint32_t reg, uint32_t v) { *(volatile uint32_t*)(g_lapic + reg) = v; }
+
+void lapic_set_base(uint32_t base) {
+    g_lapic = (volatile uint8_t*)base;
+}
+
+void lapic_enable(void) {
+    wr(LAPIC_TPR, 0);
+    wr(LAPIC_SVR, SVR_ENABLE | LAPIC_SPURIOUS_VEC);
+}
+
+uint8_t lapic_id(void) {
+    return (uint8_t)(rd(LAPIC_ID) >> 24);
+}
+
+void lapic_eoi(void) {
+    wr(LAPIC_EOI, 0);
+}
+
+static void icr_send(uint8_t apic_id, uint32_t lo) {
+    while (rd(LAPIC_ICR_LO) & ICR_PENDING) __asm__ __volatile__("pause");
+    wr(LAPIC_ICR_HI, (uint32_t)apic_id << 24);
+    wr(LAPIC_ICR_LO, lo);                       // escribir la parte baja dispara el envío
+    while (rd(LAPIC_ICR_LO) & ICR_PENDING) __asm__ __volatile__("pause");
+}
+
+void lapic_send_ipi(uint8_t apic_id, uint8_t vector) {
+    icr_send(apic_id, ICR_FIXED | ICR_LEVEL_ASSERT | vector);
+}
+
+void lapic_send_init(uint8_t apic_id) {
+    icr_send(apic_id, ICR_INIT | ICR_LEVEL_ASSERT);
+}
+
+void lapic_send_sipi(uint8_t apic_id, uint8_t page) {
+    icr_send(apic_id, ICR_STARTUP | ICR_LEVEL_ASSERT | page);
+}
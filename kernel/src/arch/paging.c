@@ -0,0 +1,72 @@
+/**
+ * @file paging.c
+ * @brief Directorio de páginas: identidad 4 MiB + ventana de páginas de 4 KiB
+ */
+#include <arch/x86/paging.h>
+#include <malloc.h>
+#include <string.h>
+
+static uint32_t g_pd[1024] __attribute__((aligned(4096)));
+static int g_enabled = 0;
+
+#define PD_INDEX(va) ((va) >> 22)
+#define PT_INDEX(va) (((va) >> 12) & 0x3FF)
+
+void paging_init(void){
+    if (g_enabled) return;
+
+    // Identidad con páginas grandes: RAM, VGA (0xA0000), LAPIC/IOAPIC, etc.
+    for (uint32_t i = 0; i < 1024; i++) {
+        uint32_t va = i << 22;
+        if (va >= VM_WINDOW_BASE && va < VM_WINDOW_END) { g_pd[i] = 0; continue; }
+        g_pd[i] = va | PDE_4M | PTE_WRITE | PTE_PRESENT;
+    }
+
+    uint32_t cr4;
+    __asm__ volatile("mov %%cr4, %0" : "=r"(cr4));
+    cr4 |= (1u << 4);                                   /* PSE */
+    __asm__ volatile("mov %0, %%cr4" :: "r"(cr4));
+    __asm__ volatile("mov %0, %%cr3" :: "r"((uint32_t)g_pd) : "memory");
+
+    uint32_t cr0;
+    __asm__ volatile("mov %%cr0, %0" : "=r"(cr0));
+    cr0 |= (1u << 31) | (1u << 16);                     /* PG | WP (el ring 0 respeta R/O) */
+    __asm__ volatile("mov %0, %%cr0" :: "r"(cr0) : "memory");
+
+    g_enabled = 1;
+}
+
+int paging_enabled(void){ return g_enabled; }
+uint32_t paging_cr3(void){ return (uint32_t)g_pd; }
+
+int paging_prepare(uint32_t va){
+    if (va < VM_WINDOW_BASE || va >= VM_WINDOW_END) return -1;
+    uint32_t* pde = &g_pd[PD_INDEX(va)];
+    if (*pde & PTE_PRESENT) return 0;
+    uint32_t* pt = (uint32_t*)memalign(PAGE_SIZE, PAGE_SIZE);
+    if (!pt) return -1;
+    memset(pt, 0, PAGE_SIZE);
+    *pde = (uint32_t)pt | PTE_WRITE | PTE_PRESENT;
+    return 0;
+}
+
+volatile uint32_t* paging_pte(uint32_t va){
+    if (va < VM_WINDOW_BASE || va >= VM_WINDOW_END) return NULL;
+    uint32_t pde = g_pd[PD_INDEX(va)];
+    if (!(pde & PTE_PRESENT)) return NULL;
+    return &((volatile uint32_t*)(pde & PAGE_MASK))[PT_INDEX(va)];
+}
+
+void paging_map(uint32_t va, uint32_t pa, uint32_t flags){
+    volatile uint32_t* pte = paging_pte(va);
+    if (!pte) return;
+    *pte = (pa & PAGE_MASK) | flags | PTE_PRESENT;
+    invlpg(va);
+}
+
+void paging_unmap(uint32_t va){
+    volatile uint32_t* pte = paging_pte(va);
+    if (!pte) return;
+    *pte = 0;
+    invlpg(va);
+}
@@ -0,0 +1,261 @@
+/**
+ * @file smp.c
+ * @brief Descubrimiento de CPUs (MADT o tabla MP), INIT-SIPI-SIPI y bucle idle de los AP
+ */
+#include <arch/x86/smp.h>
+#include <arch/x86/acpi.h>
+#include <arch/x86/bios.h>
+#include <arch/x86/idt.h>
+#include <arch/x86/lapic.h>
+#include <arch/x86/paging.h>
+#include <arch/x86/tsc.h>
+#include <drivers/pit.h>
+#include <kernel/multiboot.h>
+#include <kernel/system.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+
+#define GDT_CODE  0x00CF9A000000FFFFull
+#define GDT_DATA  0x00CF92000000FFFFull
+#define GDT_CS    0x08
+#define GDT_DS    0x10
+
+#define AP_START_TIMEOUT_US 200000
+
+extern const uint8_t ap_trampoline_start[], ap_trampoline_end[];
+extern uint32_t ap_tramp_cr3, ap_tramp_stack, ap_tramp_entry, ap_tramp_arg;
+
+static cpu_t    g_cpus[SMP_MAX_CPUS];
+static int      g_ncpus = 1;
+
+// ---------- datos por CPU ----------
+
+// Descriptor de datos de 32 bits, granularidad de byte
+static uint64_t gdt_data_desc(uint32_t base, uint32_t limit){
+    return  (uint64_t)(limit & 0xFFFF)
+          | (uint64_t)(base & 0xFFFFFF) << 16
+          | (uint64_t)0x92 << 40                        // presente, DPL0, datos R/W
+          | (uint64_t)((limit >> 16) & 0xF) << 48
+          | (uint64_t)0x4 << 52                         // D/B = 32 bits
+          | (uint64_t)(base >> 24) << 56;
+}
+
+// GDT propia con el selector GDT_PERCPU_SEL apuntando a 'c'; deja %fs cargado
+static void percpu_load(cpu_t* c){
+    c->self   = c;
+    c->gdt[0] = 0;
+    c->gdt[1] = GDT_CODE;
+    c->gdt[2] = GDT_DATA;
+    c->gdt[3] = gdt_data_desc((uint32_t)c, sizeof(cpu_t) - 1);
+
+    struct { uint16_t limit; uint32_t base; } __attribute__((packed)) gdtr =
+        { sizeof(c->gdt) - 1, (uint32_t)c->gdt };
+    __asm__ __volatile__(
+        "lgdt %0\n\t"
+        "mov %1, %%ds\n\t"
+        "mov %1, %%es\n\t"
+        "mov %1, %%ss\n\t"
+        "mov %1, %%gs\n\t"
+        "mov %2, %%fs\n\t"
+        "ljmp %3, $1f\n"
+        "1:"
+        :: "m"(gdtr), "r"((uint32_t)GDT_DS), "r"((uint32_t)GDT_PERCPU_SEL), "i"(GDT_CS)
+        : "memory");
+}
+
+int smp_cpu_count(void){ return g_ncpus; }
+
+cpu_t* smp_cpu(int i){
+    return (i >= 0 && i < g_ncpus) ? &g_cpus[i] : NULL;
+}
+
+// ---------- buzón de trabajo ----------
+
+void smp_ipi_isr(void){
+    lapic_eoi();
+}
+
+int smp_call(int cpu, smp_fn_t fn, void* arg){
+    if (cpu <= 0 || cpu >= g_ncpus || !g_cpus[cpu].online) return -1;
+    cpu_t* c = &g_cpus[cpu];
+    if (c->work_fn) return -1;
+    c->work_arg = arg;
+    __atomic_store_n(&c->work_fn, fn, __ATOMIC_RELEASE);  // el argumento antes que la función
+    lapic_send_ipi(c->apic_id, IPI_WAKEUP_VEC);
+    return 0;
+}
+
+void smp_wait(int cpu){
+    if (cpu <= 0 || cpu >= g_ncpus) return;
+    while (__atomic_load_n(&g_cpus[cpu].work_fn, __ATOMIC_ACQUIRE)) cpu_relax();
+}
+
+// Bucle de los AP: ejecuta lo que llegue al buzón; si no hay nada, hlt
+static void ap_idle_loop(cpu_t* c){
+    for (;;) {
+        disable_interrupts();
+        smp_fn_t fn = __atomic_load_n(&c->work_fn, __ATOMIC_ACQUIRE);
+        if (fn) {
+            enable_interrupts();
+            fn(c->work_arg);
+            c->work_done++;
+            __atomic_store_n(&c->work_fn, (smp_fn_t)0, __ATOMIC_RELEASE);
+            continue;
+        }
+        // sti;hlt es atómico: una IPI que llegue entre ambas despierta al hlt
+        __asm__ __volatile__("sti; hlt" ::: "memory");
+        c->wakeups++;
+    }
+}
+
+// Entrada en C de los AP (desde ap_trampoline.S, con paginación y pila propias)
+static void __attribute__((noreturn, used)) ap_main(cpu_t* c){
+    percpu_load(c);
+    idt_load();
+    lapic_enable();
+    __atomic_store_n(&c->online, 1, __ATOMIC_RELEASE);
+    ap_idle_loop(c);
+    for (;;) halt_cpu();
+}
+
+// ---------- descubrimiento ----------
+
+typedef struct __attribute__((packed)) {
+    char     sig[4];                // "_MP_"
+    uint32_t config;
+    uint8_t  length;                // en párrafos de 16 bytes
+    uint8_t  spec_rev;
+    uint8_t  checksum;
+    uint8_t  features[5];
+} mp_float_t;
+
+typedef struct __attribute__((packed)) {
+    char     sig[4];                // "PCMP"
+    uint16_t length;
+    uint8_t  spec_rev;
+    uint8_t  checksum;
+    char     oem[8];
+    char     product[12];
+    uint32_t oem_table;
+    uint16_t oem_size;
+    uint16_t entries;
+    uint32_t lapic;
+    uint16_t ext_length;
+    uint8_t  ext_checksum;
+    uint8_t  reserved;
+} mp_config_t;
+
+#define MP_PROCESSOR     0          // entrada de 20 bytes; las demás, 8
+#define MP_CPU_ENABLED   0x01
+
+static const mp_float_t* mp_scan(uint32_t base, uint32_t len){
+    for (uint32_t a = base; a + sizeof(mp_float_t) <= base + len; a += 16) {
+        const mp_float_t* f = (const mp_float_t*)a;
+        if (memcmp(f->sig, "_MP_", 4) == 0 && bios_checksum_ok(f, f->length * 16u)) return f;
+    }
+    return NULL;
+}
+
+// Tabla MP de Intel (equipos y BIOS sin MADT)
+static int mp_lapics(uint8_t* ids, int max, uint32_t* lapic_base){
+    uint32_t ebda = bios_ebda_base();
+    const mp_float_t* f = ebda ? mp_scan(ebda, 1024) : NULL;
+    if (!f) f = mp_scan(0x9FC00, 1024);
+    if (!f) f = mp_scan(0xF0000, 0x10000);
+    if (!f || !f->config || f->features[0]) return -1;   // configuración por defecto: sin tabla
+
+    const mp_config_t* cfg = (const mp_config_t*)f->config;
+    if (memcmp(cfg->sig, "PCMP", 4) != 0 || !bios_checksum_ok(cfg, cfg->length)) return -1;
+    *lapic_base = cfg->lapic;
+
+    int n = 0;
+    const uint8_t* p   = (const uint8_t*)(cfg + 1);
+    const uint8_t* end = (const uint8_t*)cfg + cfg->length;
+    for (uint16_t i = 0; i < cfg->entries && p < end; i++) {
+        if (p[0] == MP_PROCESSOR) {
+            if ((p[3] & MP_CPU_ENABLED) && n < max) ids[n++] = p[1];
+            p += 20;
+        } else {
+            p += 8;
+        }
+    }
+    return n;
+}
+
+// ---------- arranque ----------
+
+static void udelay(uint32_t us){
+    uint32_t khz = tsc_khz();
+    if (khz) {
+        uint64_t end = rdtsc() + (uint64_t)khz * us / 1000;
+        while (rdtsc() < end) cpu_relax();
+    } else {
+        uint32_t hz = pit_hz() ? pit_hz() : 100;
+        uint32_t t0 = pit_ticks, ticks = (uint32_t)((uint64_t)us * hz / 1000000) + 1;
+        while (pit_ticks - t0 < ticks) halt_cpu();
+    }
+}
+
+static int ap_start(cpu_t* c){
+    c->stack = (uint8_t*)memalign(16, SMP_AP_STACK);
+    if (!c->stack) return -1;
+
+    uint8_t* tramp = (uint8_t*)SMP_TRAMPOLINE;
+    #define TRAMP_PARAM(sym) (*(volatile uint32_t*)(tramp + ((const uint8_t*)&(sym) - ap_trampoline_start)))
+    TRAMP_PARAM(ap_tramp_cr3)   = paging_cr3();
+    TRAMP_PARAM(ap_tramp_stack) = (uint32_t)(c->stack + SMP_AP_STACK);
+    TRAMP_PARAM(ap_tramp_entry) = (uint32_t)ap_main;
+    TRAMP_PARAM(ap_tramp_arg)   = (uint32_t)c;
+    #undef TRAMP_PARAM
+
+    // Secuencia de Intel MP spec: INIT, 10 ms, SIPI, 200 µs, SIPI
+    lapic_send_init(c->apic_id);
+    udelay(10000);
+    for (int i = 0; i < 2 && !c->online; i++) {
+        lapic_send_sipi(c->apic_id, (uint8_t)(SMP_TRAMPOLINE >> 12));
+        udelay(200);
+    }
+    for (uint32_t t = 0; t < AP_START_TIMEOUT_US && !c->online; t += 100) udelay(100);
+    if (c->online) return 0;
+
+    free(c->stack);
+    c->stack = NULL;
+    return -1;
+}
+
+int smp_init(void){
+    uint8_t  ids[SMP_MAX_CPUS];
+    uint32_t base = LAPIC_DEFAULT_BASE;
+
+    g_cpus[0].id = 0;
+    percpu_load(&g_cpus[0]);
+    g_cpus[0].online = 1;
+
+    int n = acpi_madt_lapics(ids, SMP_MAX_CPUS, &base);
+    if (n <= 0) n = mp_lapics(ids, SMP_MAX_CPUS, &base);
+    if (n <= 1 || mb_cmdline_opt("nosmp")) return g_ncpus = 1;
+
+    lapic_set_base(base);
+    lapic_enable();
+    g_cpus[0].apic_id = lapic_id();
+
+    // El trampolín pisa una página baja: se guarda y se restaura al acabar
+    static uint8_t saved[4096];
+    size_t tsize = (size_t)(ap_trampoline_end - ap_trampoline_start);
+    memcpy(saved, (void*)SMP_TRAMPOLINE, sizeof(saved));
+    memcpy((void*)SMP_TRAMPOLINE, ap_trampoline_start, tsize);
+
+    for (int i = 0; i < n; i++) {
+        if (ids[i] == g_cpus[0].apic_id) continue;
+        cpu_t* c = &g_cpus[g_ncpus];
+        memset(c, 0, sizeof(*c));
+        c->id      = (uint32_t)g_ncpus;
+        c->apic_id = ids[i];
+        if (ap_start(c) == 0) g_ncpus++;
+        else printf("smp: la CPU con APIC %u no arranca\n", ids[i]);
+    }
+
+    memcpy((void*)SMP_TRAMPOLINE, saved, sizeof(saved));
+    return g_ncpus;
+}
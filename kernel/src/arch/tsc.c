@@ -0,0 +1,37 @@
+/**
+ * @file tsc.c
+ * @brief Calibración del TSC con el PIT
+ */
+#include <arch/x86/tsc.h>
+#include <drivers/pit.h>
+#include <kernel/system.h>
+
+#define TSC_CAL_MS 100
+
+static uint32_t g_tsc_khz = 0;
+
+void tsc_calibrate(void) {
+    uint32_t hz = pit_hz();
+    if (!hz) return;
+    uint32_t ticks = (hz * TSC_CAL_MS + 999) / 1000;
+    if (!ticks) ticks = 1;
+
+    // Se empieza justo en un flanco del PIT para no medir un tick parcial
+    uint32_t t0 = pit_ticks;
+    while (pit_ticks == t0) halt_cpu();
+    t0 = pit_ticks;
+    uint64_t c0 = rdtsc();
+    while (pit_ticks - t0 < ticks) halt_cpu();
+    uint64_t c1 = rdtsc();
+
+    // ciclos / (ticks / hz) s, en kHz
+    g_tsc_khz = (uint32_t)((c1 - c0) * hz / ((uint64_t)ticks * 1000u));
+}
+
+uint32_t tsc_khz(void) {
+    return g_tsc_khz;
+}
+
+uint64_t tsc_to_us(uint64_t cycles) {
+    return g_tsc_khz ? cycles * 1000u / g_tsc_khz : 0;
+}
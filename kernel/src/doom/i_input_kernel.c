@@ -0,0 +1,90 @@
+/**
+ * @file i_input_kernel.c
+ * @brief Teclado para Doom desde la cola de eventos del driver PS/2
+ *
+ * Con --wrap=DG_GetKey, I_GetEvent recibe aquí cada pulsación y cada
+ * soltado (kbd_read_events) ya traducidos a las teclas de doomkeys.h,
+ * incluidas las extendidas (cursores, Ctrl/Alt derechos, Inicio/Fin...).
+ * Los eventos se sacan de la cola del driver en tandas de KEY_BATCH.
+ */
+#include "doomtype.h"
+#include "doomkeys.h"
+
+#include <drivers/keyboard.h>
+
+#define KEY_BATCH 16
+
+void I_LatencyInput(uint64_t isr_tsc);
+
+static kbd_event_t key_batch[KEY_BATCH];
+static size_t      key_n = 0, key_i = 0;
+
+// Tecla de Doom para un código set 1 (0 = ignorar)
+static unsigned char I_KernelKey(uint16_t sc){
+    if (sc == KBD_SC_PAUSE) return KEY_PAUSE;
+
+    if (sc & KBD_SC_EXT) {
+        switch (sc & 0x7F) {
+            case 0x48: return KEY_UPARROW;
+            case 0x50: return KEY_DOWNARROW;
+            case 0x4B: return KEY_LEFTARROW;
+            case 0x4D: return KEY_RIGHTARROW;
+            case 0x1D: return KEY_FIRE;         // Ctrl derecho
+            case 0x38: return KEY_RALT;
+            case 0x1C: return KEYP_ENTER;
+            case 0x35: return KEYP_DIVIDE;
+            case 0x37: return KEY_PRTSCR;
+            case 0x47: case 0x4F: case 0x49: case 0x51: case 0x52: case 0x53:
+                return (unsigned char)(0x80 + (sc & 0x7F));   // Inicio, Fin, RePág, AvPág, Ins, Supr
+            default:   return 0;
+        }
+    }
+
+    switch (sc) {
+        case 0x01: return KEY_ESCAPE;
+        case 0x0C: return KEY_MINUS;
+        case 0x0D: return KEY_EQUALS;
+        case 0x0E: return KEY_BACKSPACE;
+        case 0x0F: return KEY_TAB;
+        case 0x1C: return KEY_ENTER;
+        case 0x1D: return KEY_FIRE;             // Ctrl izquierdo
+        case 0x2A: case 0x36: return KEY_RSHIFT;
+        case 0x37: return KEYP_MULTIPLY;
+        case 0x38: return KEY_LALT;
+        case 0x39: return KEY_USE;              // espacio
+        case 0x3A: return KEY_CAPSLOCK;
+        case 0x45: return KEY_NUMLOCK;
+        case 0x46: return KEY_SCRLCK;
+        case 0x48: return KEY_UPARROW;          // teclado numérico sin Bloq Num
+        case 0x50: return KEY_DOWNARROW;
+        case 0x4B: return KEY_LEFTARROW;
+        case 0x4D: return KEY_RIGHTARROW;
+        case 0x4A: return KEYP_MINUS;
+        case 0x4E: return KEYP_PLUS;
+        case 0x57: return KEY_F11;
+        case 0x58: return KEY_F12;
+    }
+    if (sc >= 0x3B && sc <= 0x44) return (unsigned char)(0x80 + sc);     // F1..F10
+    if (sc >= 0x47 && sc <= 0x53) return (unsigned char)(0x80 + sc);     // resto del numérico
+
+    // Teclas de texto: el carácter sin mayúsculas de la distribución activa
+    unsigned char ch = (unsigned char)kbd_table_unshift()[sc & 0x7F];
+    return ch < 0x80 ? ch : 0;
+}
+
+int __wrap_DG_GetKey(int* pressed, unsigned char* doomKey){
+    for (;;) {
+        if (key_i == key_n) {
+            key_n = kbd_read_events(key_batch, KEY_BATCH);
+            key_i = 0;
+            if (key_n == 0) return 0;
+        }
+        const kbd_event_t* ev = &key_batch[key_i++];
+        unsigned char key = I_KernelKey(ev->scancode);
+        if (!key) continue;
+        if (ev->pressed) I_LatencyInput(ev->tsc);
+        *pressed = ev->pressed;
+        *doomKey = key;
+        return 1;
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * @file i_latency_kernel.c
+ * @brief Modo de diagnóstico: latencia de la entrada hasta la pantalla
+ *
+ * Con "latency" en la línea de comandos del kernel se toman tres marcas
+ * del TSC por cada pulsación (o paquete de ratón) que llega a Doom:
+ *
+ *   isr     → la ISR del teclado/ratón recibe el código (kbd_event_t.tsc)
+ *   evento  → Doom lo recoge en I_StartTic, justo antes de D_ProcessEvents
+ *   pantalla→ termina el siguiente DG_DrawFrame (--wrap=DG_DrawFrame): es el
+ *             primer fotograma dibujado después del tic que procesó el evento
+ *
+ * Al salir (atexit) se imprimen los histogramas de cada tramo y del total.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "doomtype.h"
+
+#include <arch/x86/tsc.h>
+#include <kernel/lathist.h>
+#include <kernel/multiboot.h>
+
+#define LAT_PENDING 32      /* eventos a la espera del siguiente fotograma */
+
+typedef struct {
+    uint64_t isr, event;
+} lat_sample_t;
+
+static int          lat_enabled = -1;   /* -1: sin consultar la cmdline */
+static lat_sample_t lat_pending[LAT_PENDING];
+static int          lat_npending = 0;
+static uint32_t     lat_lost = 0;
+
+static lathist_t lat_isr_event   = LATHIST_INIT("latencia isr->evento");
+static lathist_t lat_event_frame = LATHIST_INIT("latencia evento->pantalla");
+static lathist_t lat_total       = LATHIST_INIT("latencia isr->pantalla");
+
+void __real_DG_DrawFrame(void);
+
+static void I_LatencyReport(void){
+    lathist_dump(&lat_isr_event);
+    lathist_dump(&lat_event_frame);
+    lathist_dump(&lat_total);
+    if (lat_lost) printf("latencia: %lu eventos sin medir\n", (unsigned long)lat_lost);
+}
+
+static int I_LatencyEnabled(void){
+    if (lat_enabled < 0) {
+        lat_enabled = mb_cmdline_opt("latency") != NULL;
+        if (lat_enabled) atexit(I_LatencyReport);
+    }
+    return lat_enabled;
+}
+
+// Doom acaba de recibir una entrada que llegó a la ISR en 'isr_tsc'
+void I_LatencyInput(uint64_t isr_tsc){
+    if (!I_LatencyEnabled()) return;
+    if (lat_npending == LAT_PENDING) { lat_lost++; return; }
+    lat_pending[lat_npending++] = (lat_sample_t){ isr_tsc, rdtsc() };
+}
+
+void __wrap_DG_DrawFrame(void){
+    __real_DG_DrawFrame();
+    if (lat_npending == 0) return;
+
+    uint64_t now = rdtsc();
+    for (int i = 0; i < lat_npending; i++) {
+        lathist_add(&lat_isr_event,   lat_pending[i].event - lat_pending[i].isr);
+        lathist_add(&lat_event_frame, now - lat_pending[i].event);
+        lathist_add(&lat_total,       now - lat_pending[i].isr);
+    }
+    lat_npending = 0;
+}
@@ -0,0 +1,32 @@
+/**
+ * @file i_mouse_kernel.c
+ * @brief Ratón PS/2 para Doom: un evento ev_mouse por tic
+ *
+ * Con --wrap=I_StartTic, después de los eventos de teclado se recoge el
+ * movimiento que la ISR ha ido acumulando (mouse_poll) y se publica como
+ * un único ev_mouse, por muchos paquetes que haya enviado el ratón.
+ */
+#include "doomtype.h"
+#include "d_event.h"
+
+#include <drivers/mouse.h>
+
+void __real_I_StartTic(void);
+void I_LatencyInput(uint64_t isr_tsc);
+
+void __wrap_I_StartTic(void){
+    __real_I_StartTic();
+
+    mouse_state_t ms;
+    if (!mouse_present() || !mouse_poll(&ms)) return;
+    if (ms.packets) I_LatencyInput(ms.tsc);
+
+    // data1: botones (izq, der, centro = bits 0..2, igual que PS/2)
+    // data2/data3: giro y avance; en PS/2 dy > 0 ya es "hacia delante"
+    event_t ev = { 0 };
+    ev.type  = ev_mouse;
+    ev.data1 = ms.buttons;
+    ev.data2 = ms.dx;
+    ev.data3 = ms.dy;
+    D_PostEvent(&ev);
+}
@@ -0,0 +1,30 @@
+/**
+ * @file i_sleep_kernel.c
+ * @brief Aprovecha las esperas entre tics de Doom para el trabajo diferido
+ *
+ * TryRunTics (d_loop.c) llama a I_Sleep(1) mientras no toca el siguiente
+ * tic. Con --wrap=I_Sleep ese hueco ejecuta primero idle_run() (p.ej. el
+ * volcado de la partida guardada) y luego duerme lo que quede; si hay más
+ * hilos, con thread_sleep_ms para que se ejecuten mientras tanto. La primera
+ * llamada registra la precarga del siguiente mapa (w_prefetch.c): para
+ * entonces W_Init y R_Init ya han terminado.
+ */
+#include "doomtype.h"
+#include "i_timer.h"
+
+#include <kernel/idle.h>
+#include <kernel/thread.h>
+
+void __real_I_Sleep(int ms);
+void W_PrefetchIdle(void);
+
+void __wrap_I_Sleep(int ms){
+    static boolean registered = false;
+    if (!registered) {
+        idle_register(W_PrefetchIdle);
+        registered = true;
+    }
+    idle_run();
+    if (thread_count() > 1) thread_sleep_ms((uint32_t)ms);     // que corran los demás hilos
+    else                    __real_I_Sleep(ms);
+}
@@ -0,0 +1,279 @@
+/**
+ * @file r_data_cache.c
+ * @brief Caché de R_InitData generada fuera de línea y cargada desde la imagen
+ *
+ * Se enlaza con -Wl,--wrap=R_InitData (ver Makefile.in). R_InitTextures y
+ * R_InitSpriteLumps recorren miles de lumps (PNAMES, TEXTURE1/2, cada
+ * parche y cada sprite) en cada arranque. Si la imagen trae RDCACHE.BIN
+ * (en el initrd o en la raíz del volumen FAT) y su suma SHA-1 de los WAD
+ * (W_Checksum) coincide, se lee de una vez y los globales de r_data.c
+ * apuntan dentro de ese bloque; si no, se ejecuta el R_InitData original.
+ *
+ * El volumen FAT es un módulo en RAM, así que lo que se escribiera en él se
+ * perdería al apagar: el fichero no se guarda en cada arranque. Con
+ * -rdcachegen se vuelca por el puerto de depuración de QEMU (0xE9,
+ * -debugcon file:RDCACHE.BIN) para copiarlo después a la imagen.
+ *
+ * Se guardan las definiciones de texturas, sus tablas de columnas
+ * (texturecolumnlump/ofs), máscaras, alturas y tamaños de composición, y
+ * ancho/offsets de sprites. Flats y COLORMAP se cargan como siempre (son
+ * unas pocas búsquedas por nombre). Las texturas compuestas no existen
+ * todavía al salir de R_InitData: R_GetColumn las genera bajo demanda.
+ * Con -nordcache se ignora la caché.
+ */
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <arch/x86/io.h>
+
+#include "doomtype.h"
+#include "deh_str.h"
+#include "m_argv.h"
+#include "m_fixed.h"
+#include "sha1.h"
+#include "w_checksum.h"
+#include "w_wad.h"
+#include "z_zone.h"
+
+#define RDCACHE_DEBUGCON 0xE9         /* QEMU -debugcon */
+#define RDCACHE_MAGIC   "RDC1"
+
+/* Copia de las estructuras privadas de r_data.c: deben coincidir */
+typedef struct {
+    short originx;
+    short originy;
+    int   patch;
+} rdc_texpatch_t;
+
+typedef struct rdc_texture_s {
+    char   name[8];
+    short  width;
+    short  height;
+    int    index;
+    struct rdc_texture_s *next;
+    short  patchcount;
+    rdc_texpatch_t patches[1];
+} rdc_texture_t;
+
+/* Globales de r_data.c */
+extern int              firstflat, lastflat, numflats;
+extern int              firstspritelump, lastspritelump, numspritelumps;
+extern int              numtextures;
+extern rdc_texture_t  **textures;
+extern rdc_texture_t  **textures_hashtable;
+extern int             *texturewidthmask;
+extern fixed_t         *textureheight;
+extern int             *texturecompositesize;
+extern short          **texturecolumnlump;
+extern unsigned short **texturecolumnofs;
+extern byte           **texturecomposite;
+extern int             *flattranslation;
+extern int             *texturetranslation;
+extern fixed_t         *spritewidth, *spriteoffset, *spritetopoffset;
+extern byte            *colormaps;
+
+void __real_R_InitData(void);
+
+/* Cabecera del fichero; los offsets son relativos al inicio */
+typedef struct {
+    char     magic[4];
+    uint32_t layout;            /* cambia si cambian las estructuras de arriba */
+    sha1_digest_t sha1;
+    uint32_t numlumps;
+    int32_t  numtextures;
+    int32_t  numspritelumps;
+    uint32_t size;
+    uint32_t tex_off;           /* uint32_t[numtextures]: offset de cada rdc_texture_t */
+    uint32_t widthmask_off;     /* int[numtextures] */
+    uint32_t height_off;        /* fixed_t[numtextures] */
+    uint32_t compsize_off;      /* int[numtextures] */
+    uint32_t collump_off;       /* uint32_t[numtextures]: offset de short[width] */
+    uint32_t colofs_off;        /* uint32_t[numtextures]: offset de unsigned short[width] */
+    uint32_t sprite_off;        /* fixed_t[3][numspritelumps] */
+} rdc_header_t;
+
+#define RDC_LAYOUT ((uint32_t)(sizeof(rdc_texture_t) << 16 | sizeof(rdc_texpatch_t) << 8 | sizeof(rdc_header_t)))
+
+static uint32_t align4(uint32_t x){ return (x + 3) & ~3u; }
+
+static uint32_t texture_bytes(const rdc_texture_t *t){
+    return (uint32_t)(sizeof(rdc_texture_t) + sizeof(rdc_texpatch_t) * (t->patchcount - 1));
+}
+
+// ---------- lo que no se guarda: igual que r_data.c ----------
+static void RDC_InitFlats(void){
+    firstflat = W_GetNumForName(DEH_String("F_START")) + 1;
+    lastflat  = W_GetNumForName(DEH_String("F_END")) - 1;
+    numflats  = lastflat - firstflat + 1;
+    flattranslation = Z_Malloc((numflats + 1) * sizeof(*flattranslation), PU_STATIC, 0);
+    for (int i = 0; i < numflats; i++) flattranslation[i] = i;
+}
+
+static void RDC_InitColormaps(void){
+    colormaps = W_CacheLumpNum(W_GetNumForName(DEH_String("COLORMAP")), PU_STATIC);
+}
+
+// Como GenerateTextureHashTable: en colisión gana la primera textura
+static void RDC_HashTextures(void){
+    textures_hashtable = Z_Malloc(sizeof(*textures_hashtable) * numtextures, PU_STATIC, 0);
+    memset(textures_hashtable, 0, sizeof(*textures_hashtable) * numtextures);
+    for (int i = 0; i < numtextures; i++) {
+        textures[i]->index = i;
+        textures[i]->next = NULL;
+        rdc_texture_t **rover = &textures_hashtable[W_LumpNameHash(textures[i]->name) % numtextures];
+        while (*rover) rover = &(*rover)->next;
+        *rover = textures[i];
+    }
+}
+
+// ---------- carga ----------
+// Primero el initrd (sin copia) y después la raíz del volumen FAT
+static const char *const rdc_paths[] = { "/initrd/RDCACHE.BIN", "RDCACHE.BIN" };
+
+static int RDC_InRange(const rdc_header_t *h, uint32_t off, uint32_t len){
+    return off <= h->size && len <= h->size - off;
+}
+
+static int RDC_Load(const sha1_digest_t sum){
+    FILE *f = NULL;
+    for (size_t i = 0; !f && i < sizeof(rdc_paths) / sizeof(rdc_paths[0]); i++)
+        f = fopen(rdc_paths[i], "rb");
+    if (!f) return 0;
+
+    rdc_header_t h;
+    int ok = fread(&h, sizeof(h), 1, f) == 1 &&
+             memcmp(h.magic, RDCACHE_MAGIC, 4) == 0 && h.layout == RDC_LAYOUT &&
+             memcmp(h.sha1, sum, sizeof(sha1_digest_t)) == 0 && h.numlumps == numlumps &&
+             h.numtextures > 0 && h.numspritelumps >= 0 && h.size >= sizeof(h);
+    byte *blob = NULL;
+    if (ok) {
+        // Una sola lectura secuencial; el bloque queda fijo en memoria
+        blob = Z_Malloc(h.size, PU_STATIC, 0);
+        memcpy(blob, &h, sizeof(h));
+        ok = fread(blob + sizeof(h), 1, h.size - sizeof(h), f) == h.size - sizeof(h);
+    }
+    fclose(f);
+    if (!ok) {
+        if (blob) Z_Free(blob);
+        return 0;
+    }
+
+    uint32_t n = (uint32_t)h.numtextures, ns = (uint32_t)h.numspritelumps;
+    ok = n <= h.size / 4 && ns <= h.size / 12 &&
+         RDC_InRange(&h, h.tex_off, n * 4) && RDC_InRange(&h, h.widthmask_off, n * 4) &&
+         RDC_InRange(&h, h.height_off, n * 4) && RDC_InRange(&h, h.compsize_off, n * 4) &&
+         RDC_InRange(&h, h.collump_off, n * 4) && RDC_InRange(&h, h.colofs_off, n * 4) &&
+         RDC_InRange(&h, h.sprite_off, ns * 12);
+    const uint32_t *tex_off = (const uint32_t *)(blob + h.tex_off);
+    const uint32_t *cl_off  = (const uint32_t *)(blob + h.collump_off);
+    const uint32_t *co_off  = (const uint32_t *)(blob + h.colofs_off);
+    for (uint32_t i = 0; ok && i < n; i++) {
+        const rdc_texture_t *t = (const rdc_texture_t *)(blob + tex_off[i]);
+        ok = RDC_InRange(&h, tex_off[i], sizeof(rdc_texture_t)) && t->patchcount > 0 &&
+             RDC_InRange(&h, tex_off[i], texture_bytes(t)) && t->width > 0 &&
+             RDC_InRange(&h, cl_off[i], t->width * 2) && RDC_InRange(&h, co_off[i], t->width * 2);
+    }
+    // Otro reparto de sprites con la misma suma (p.ej. un PWAD): se recalcula todo
+    int first_sprite = W_GetNumForName(DEH_String("S_START")) + 1;
+    int last_sprite  = W_GetNumForName(DEH_String("S_END")) - 1;
+    if (ok && (uint32_t)(last_sprite - first_sprite + 1) != ns) ok = 0;
+    if (!ok) {
+        Z_Free(blob);
+        return 0;
+    }
+
+    numtextures = (int)n;
+    textures             = Z_Malloc(n * sizeof(*textures), PU_STATIC, 0);
+    texturecolumnlump    = Z_Malloc(n * sizeof(*texturecolumnlump), PU_STATIC, 0);
+    texturecolumnofs     = Z_Malloc(n * sizeof(*texturecolumnofs), PU_STATIC, 0);
+    texturecomposite     = Z_Malloc(n * sizeof(*texturecomposite), PU_STATIC, 0);
+    texturetranslation   = Z_Malloc((n + 1) * sizeof(*texturetranslation), PU_STATIC, 0);
+    texturewidthmask     = (int *)(blob + h.widthmask_off);
+    textureheight        = (fixed_t *)(blob + h.height_off);
+    texturecompositesize = (int *)(blob + h.compsize_off);
+    for (uint32_t i = 0; i < n; i++) {
+        textures[i]          = (rdc_texture_t *)(blob + tex_off[i]);
+        texturecolumnlump[i] = (short *)(blob + cl_off[i]);
+        texturecolumnofs[i]  = (unsigned short *)(blob + co_off[i]);
+        texturecomposite[i]  = NULL;            // R_GetColumn las compone al usarlas
+        texturetranslation[i] = (int)i;
+    }
+    RDC_HashTextures();
+
+    firstspritelump = first_sprite;
+    lastspritelump  = last_sprite;
+    numspritelumps  = (int)ns;
+    spritewidth     = (fixed_t *)(blob + h.sprite_off);
+    spriteoffset    = spritewidth + ns;
+    spritetopoffset = spriteoffset + ns;
+    return 1;
+}
+
+// ---------- generación (-rdcachegen) ----------
+static void RDC_Dump(const sha1_digest_t sum){
+    uint32_t n = (uint32_t)numtextures, ns = (uint32_t)numspritelumps;
+    rdc_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, RDCACHE_MAGIC, 4);
+    h.layout = RDC_LAYOUT;
+    memcpy(h.sha1, sum, sizeof(sha1_digest_t));
+    h.numlumps = numlumps;
+    h.numtextures = (int32_t)n;
+    h.numspritelumps = (int32_t)ns;
+
+    uint32_t off = align4(sizeof(h));
+    h.tex_off       = off; off += n * 4;
+    h.widthmask_off = off; off += n * 4;
+    h.height_off    = off; off += n * 4;
+    h.compsize_off  = off; off += n * 4;
+    h.collump_off   = off; off += n * 4;
+    h.colofs_off    = off; off += n * 4;
+    h.sprite_off    = off; off += ns * 12;
+    uint32_t data = off;
+    for (uint32_t i = 0; i < n; i++)
+        off += align4(texture_bytes(textures[i])) + 2 * align4(textures[i]->width * 2);
+    h.size = off;
+
+    byte *blob = Z_Malloc(h.size, PU_STATIC, 0);
+    memset(blob, 0, h.size);
+    uint32_t *tex_off = (uint32_t *)(blob + h.tex_off);
+    uint32_t *cl_off  = (uint32_t *)(blob + h.collump_off);
+    uint32_t *co_off  = (uint32_t *)(blob + h.colofs_off);
+    memcpy(blob + h.widthmask_off, texturewidthmask, n * 4);
+    memcpy(blob + h.height_off, textureheight, n * 4);
+    memcpy(blob + h.compsize_off, texturecompositesize, n * 4);
+    memcpy(blob + h.sprite_off, spritewidth, ns * 4);
+    memcpy(blob + h.sprite_off + ns * 4, spriteoffset, ns * 4);
+    memcpy(blob + h.sprite_off + ns * 8, spritetopoffset, ns * 4);
+
+    off = data;
+    for (uint32_t i = 0; i < n; i++) {
+        const rdc_texture_t *t = textures[i];
+        uint32_t w = (uint32_t)t->width * 2;
+        tex_off[i] = off; memcpy(blob + off, t, texture_bytes(t)); off += align4(texture_bytes(t));
+        cl_off[i]  = off; memcpy(blob + off, texturecolumnlump[i], w); off += align4(w);
+        co_off[i]  = off; memcpy(blob + off, texturecolumnofs[i], w);  off += align4(w);
+    }
+    memcpy(blob, &h, sizeof(h));
+
+    for (uint32_t i = 0; i < h.size; i++) outb(RDCACHE_DEBUGCON, blob[i]);
+    printf(" (rdcache: %u bytes por 0x%x)", (unsigned)h.size, RDCACHE_DEBUGCON);
+    Z_Free(blob);
+}
+
+void __wrap_R_InitData(void){
+    sha1_digest_t sum;
+    int gen = M_CheckParm("-rdcachegen") > 0;
+    int use = !gen && !M_CheckParm("-nordcache");
+    if (use || gen) W_Checksum(sum);
+
+    if (use && RDC_Load(sum)) {
+        RDC_InitFlats();
+        RDC_InitColormaps();
+        printf(" (rdcache)");
+        return;
+    }
+    __real_R_InitData();
+    if (gen) RDC_Dump(sum);
+}
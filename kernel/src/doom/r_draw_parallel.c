@@ -0,0 +1,193 @@
+/**
+ * @file r_draw_parallel.c
+ * @brief Dibujo de columnas y spans de la vista repartido en franjas verticales entre CPUs
+ *
+ * Con --wrap, durante R_RenderPlayerView las llamadas a R_DrawColumn,
+ * R_DrawTranslatedColumn y R_DrawSpan no dibujan: guardan sus parámetros en
+ * una cola. Al terminar la vista (o antes, si hace falta) la cola se vacía
+ * con parallel_for: cada CPU recorre la cola entera en orden y dibuja sólo
+ * los píxeles de su franja [x0, x1). Como una columna escribe una única x y
+ * un span se recorta sin cambiar su paso, cada píxel recibe las mismas
+ * escrituras en el mismo orden que en serie: la imagen es idéntica bit a bit.
+ *
+ * La cola se vacía antes de:
+ *  - R_DrawFuzzColumn, que lee los píxeles vecinos y avanza un contador
+ *    global, así que se ejecuta en serie sobre la vista ya dibujada;
+ *  - Z_Malloc, que puede purgar bloques PU_CACHE a los que apuntan
+ *    dc_source y ds_source.
+ *
+ * El recorrido del BSP, los clips y los visplanes siguen en la CPU que
+ * ejecuta Doom. El modo de bajo detalle (R_Draw*Low) no se intercepta.
+ * Se desactiva con -noparallel y no hace nada si task_workers() == 1.
+ */
+#include <stdint.h>
+
+#include "doomtype.h"
+#include "i_video.h"
+#include "m_argv.h"
+#include "r_local.h"
+#include "z_zone.h"
+
+#include <kernel/task.h>
+
+#define RD_MAX_JOBS     8192
+
+extern byte* ylookup[];
+extern int   columnofs[];
+
+void  __real_R_RenderPlayerView(player_t* player);
+void  __real_R_DrawColumn(void);
+void  __real_R_DrawTranslatedColumn(void);
+void  __real_R_DrawFuzzColumn(void);
+void  __real_R_DrawSpan(void);
+void* __real_Z_Malloc(int size, int tag, void* user);
+
+typedef enum {
+    RD_COLUMN,
+    RD_TRANSLATED,
+    RD_SPAN,
+} rd_kind_t;
+
+typedef struct {
+    uint8_t             kind;
+    int16_t             x1, x2;         /* columna: x1 == x2 */
+    int16_t             y1, y2;         /* span: y1 == y2 */
+    uint32_t            frac, step;     /* columna: frac en y1; span: posición empaquetada */
+    const lighttable_t* colormap;
+    const byte*         source;
+    const byte*         translation;
+} rd_job_t;
+
+static rd_job_t rd_jobs[RD_MAX_JOBS];
+static int      rd_njobs;
+static int      rd_enabled = -1;        /* -1: sin consultar */
+static int      rd_active;              /* dentro de R_RenderPlayerView */
+static int      rd_nstrips;
+
+// ---------- reproducción (mismos bucles que r_draw.c) ----------
+
+static void RD_Column(const rd_job_t* j){
+    byte*   dest = ylookup[j->y1] + columnofs[j->x1];
+    fixed_t frac = (fixed_t)j->frac;
+    fixed_t step = (fixed_t)j->step;
+    int     count = j->y2 - j->y1;
+
+    if (j->kind == RD_TRANSLATED) {
+        do {
+            *dest = j->colormap[j->translation[j->source[frac >> FRACBITS]]];
+            dest += SCREENWIDTH;
+            frac += step;
+        } while (count--);
+    } else {
+        do {
+            *dest = j->colormap[j->source[(frac >> FRACBITS) & 127]];
+            dest += SCREENWIDTH;
+            frac += step;
+        } while (count--);
+    }
+}
+
+static void RD_Span(const rd_job_t* j, int x0, int x1){
+    int a = j->x1 > x0 ? j->x1 : x0;
+    int b = j->x2 < x1 - 1 ? j->x2 : x1 - 1;
+    if (a > b) return;
+
+    uint32_t position = j->frac + (uint32_t)(a - j->x1) * j->step;
+    byte*    dest = ylookup[j->y1] + columnofs[a];
+    int      count = b - a;
+    do {
+        unsigned ytemp = (position >> 4) & 0x0fc0;
+        unsigned xtemp = position >> 26;
+        *dest++ = j->colormap[j->source[xtemp | ytemp]];
+        position += j->step;
+    } while (count--);
+}
+
+static void RD_Strip(void* ctx, int lo, int hi){
+    for (int s = lo; s < hi; s++) {
+        int x0 = viewwidth * s / rd_nstrips;
+        int x1 = viewwidth * (s + 1) / rd_nstrips;
+        for (int i = 0; i < rd_njobs; i++) {
+            const rd_job_t* j = &rd_jobs[i];
+            if (j->kind == RD_SPAN)                   RD_Span(j, x0, x1);
+            else if (j->x1 >= x0 && j->x1 < x1)       RD_Column(j);
+        }
+    }
+}
+
+static void RD_Flush(void){
+    if (rd_njobs == 0) return;
+    parallel_for(0, rd_nstrips, 1, RD_Strip, NULL);
+    rd_njobs = 0;
+}
+
+static rd_job_t* RD_Push(void){
+    if (rd_njobs == RD_MAX_JOBS) RD_Flush();
+    return &rd_jobs[rd_njobs++];
+}
+
+static void RD_PushColumn(rd_kind_t kind){
+    if (dc_yh < dc_yl) return;              // r_draw.c tampoco dibuja nada
+    rd_job_t* j = RD_Push();
+    j->kind        = (uint8_t)kind;
+    j->x1 = j->x2  = (int16_t)dc_x;
+    j->y1          = (int16_t)dc_yl;
+    j->y2          = (int16_t)dc_yh;
+    j->frac        = (uint32_t)(dc_texturemid + (dc_yl - centery) * dc_iscale);
+    j->step        = (uint32_t)dc_iscale;
+    j->colormap    = dc_colormap;
+    j->source      = dc_source;
+    j->translation = dc_translation;
+}
+
+// ---------- envolturas ----------
+
+void __wrap_R_RenderPlayerView(player_t* player){
+    if (rd_enabled < 0) rd_enabled = task_workers() > 1 && !M_CheckParm("-noparallel");
+    if (!rd_enabled) {
+        __real_R_RenderPlayerView(player);
+        return;
+    }
+
+    rd_nstrips = task_workers();
+    rd_active = 1;
+    __real_R_RenderPlayerView(player);
+    RD_Flush();                             // antes del HUD y de I_FinishUpdate
+    rd_active = 0;
+}
+
+void __wrap_R_DrawColumn(void){
+    if (rd_active) RD_PushColumn(RD_COLUMN);
+    else           __real_R_DrawColumn();
+}
+
+void __wrap_R_DrawTranslatedColumn(void){
+    if (rd_active) RD_PushColumn(RD_TRANSLATED);
+    else           __real_R_DrawTranslatedColumn();
+}
+
+void __wrap_R_DrawFuzzColumn(void){
+    RD_Flush();
+    __real_R_DrawFuzzColumn();
+}
+
+void __wrap_R_DrawSpan(void){
+    if (!rd_active) {
+        __real_R_DrawSpan();
+        return;
+    }
+    rd_job_t* j = RD_Push();
+    j->kind     = RD_SPAN;
+    j->x1       = (int16_t)ds_x1;
+    j->x2       = (int16_t)ds_x2;
+    j->y1 = j->y2 = (int16_t)ds_y;
+    j->frac     = (((uint32_t)ds_xfrac << 10) & 0xffff0000) | (((uint32_t)ds_yfrac >> 6) & 0x0000ffff);
+    j->step     = (((uint32_t)ds_xstep << 10) & 0xffff0000) | (((uint32_t)ds_ystep >> 6) & 0x0000ffff);
+    j->colormap = ds_colormap;
+    j->source   = ds_source;
+}
+
+void* __wrap_Z_Malloc(int size, int tag, void* user){
+    RD_Flush();
+    return __real_Z_Malloc(size, tag, user);
+}
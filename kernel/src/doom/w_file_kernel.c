@@ -0,0 +1,226 @@
+/**
+ * @file w_file_kernel.c
+ * @brief Proveedor de WAD del kernel (sustituye a w_file_stdc.c de doomgeneric)
+ *
+ * w_file.c abre siempre los WAD a través de 'stdc_wad_file', así que esta
+ * clase conserva ese nombre. El IWAD se carga entero una sola vez en una
+ * región contigua (o se usa directamente el initrd/módulo Multiboot) y se
+ * publica en wad->mapped: W_CacheLumpNum devuelve entonces punteros dentro
+ * de esa región, sin Z_Malloc ni copias. Si no hay memoria se recurre al
+ * camino clásico fseek+fread.
+ *
+ * Un WAD comprimido (kernel/wadlz4.h, generado con tools/wadlz4.c) se
+ * reconoce por su cabecera y se presenta a w_wad.c como el WAD original:
+ * wad->mapped queda a NULL, así que W_CacheLumpNum pide cada lump con
+ * W_Read la primera vez y el lump se descomprime directamente en el bloque
+ * de zona. Sólo se lee y descomprime lo que Doom llega a usar.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "w_file.h"
+#include "z_zone.h"
+#include "m_misc.h"
+
+#include <kernel/filemap.h>
+#include <kernel/lz4.h>
+#include <kernel/wadlz4.h>
+
+typedef struct {
+    wad_file_t  wad;
+    kfile_map_t map;        /* región precargada (wad.mapped) */
+    FILE*       fstream;    /* sólo si no se pudo precargar */
+    /* WAD comprimido (ext != NULL) */
+    wadlz4_extent_t* ext;
+    uint32_t    next;
+    uint8_t*    scratch;    /* última extensión descomprimida, para lecturas parciales */
+    int         scratch_idx;
+    uint8_t*    cbuf;       /* datos comprimidos leídos de fstream */
+    uint32_t    cbuf_size;
+} kernel_wad_file_t;
+
+extern wad_file_class_t stdc_wad_file;
+
+// ---------- WAD comprimido ----------
+
+// Lee la cabecera y la tabla de extensiones; 0 si el fichero no es un WAD LZ4
+static int lz_open(kernel_wad_file_t *kwad, uint32_t csize){
+    wadlz4_header_t h;
+    if (csize < sizeof(h)) return 0;
+    if (kwad->map.data) memcpy(&h, kwad->map.data, sizeof(h));
+    else if (fseek(kwad->fstream, 0, SEEK_SET) != 0 ||
+             fread(&h, sizeof(h), 1, kwad->fstream) != 1) return 0;
+    if (memcmp(h.magic, WADLZ4_MAGIC, 4) != 0 || h.version != WADLZ4_VERSION) return 0;
+    if (h.nextents > (csize - sizeof(h)) / sizeof(wadlz4_extent_t)) return -1;
+
+    size_t tsize = h.nextents * sizeof(wadlz4_extent_t);
+    wadlz4_extent_t *ext = Z_Malloc(tsize ? tsize : 1, PU_STATIC, 0);
+    if (kwad->map.data) memcpy(ext, (const byte *)kwad->map.data + sizeof(h), tsize);
+    else if (tsize && fread(ext, tsize, 1, kwad->fstream) != 1) { Z_Free(ext); return -1; }
+
+    // Ordenadas, dentro del WAD original y con los datos dentro del fichero
+    uint32_t vend = 0;
+    for (uint32_t i = 0; i < h.nextents; i++) {
+        const wadlz4_extent_t *e = &ext[i];
+        if (e->vpos < vend || e->vsize > h.vsize - e->vpos ||
+            e->cpos > csize || e->csize > csize - e->cpos) { Z_Free(ext); return -1; }
+        vend = e->vpos + e->vsize;
+    }
+    kwad->ext = ext;
+    kwad->next = h.nextents;
+    kwad->wad.length = h.vsize;
+    kwad->wad.mapped = NULL;          // cada lump pasa por W_Read y se descomprime
+    return 1;
+}
+
+// Última extensión con vpos <= pos (-1 si ninguna)
+static int lz_find(const kernel_wad_file_t *kwad, uint32_t pos){
+    int lo = 0, hi = (int)kwad->next - 1, r = -1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (kwad->ext[mid].vpos <= pos) { r = mid; lo = mid + 1; }
+        else hi = mid - 1;
+    }
+    return r;
+}
+
+// [cpos, cpos+n) del fichero comprimido: puntero directo si está precargado
+static const byte *lz_fetch(kernel_wad_file_t *kwad, uint32_t cpos, uint32_t n){
+    if (kwad->map.data) return (const byte *)kwad->map.data + cpos;
+    if (n > kwad->cbuf_size) {
+        if (kwad->cbuf) Z_Free(kwad->cbuf);
+        kwad->cbuf = Z_Malloc(n, PU_STATIC, 0);
+        kwad->cbuf_size = n;
+    }
+    if (fseek(kwad->fstream, cpos, SEEK_SET) != 0 ||
+        fread(kwad->cbuf, 1, n, kwad->fstream) != n) return NULL;
+    return kwad->cbuf;
+}
+
+static int lz_inflate(kernel_wad_file_t *kwad, const wadlz4_extent_t *e, byte *dst){
+    const byte *src = lz_fetch(kwad, e->cpos, e->csize);
+    return src && lz4_decompress(src, e->csize, dst, e->vsize) == (int)e->vsize;
+}
+
+static size_t lz_read(kernel_wad_file_t *kwad, unsigned int offset,
+                      byte *dst, size_t len){
+    if (offset >= kwad->wad.length) return 0;
+    if (len > kwad->wad.length - offset) len = kwad->wad.length - offset;
+
+    size_t done = 0;
+    while (done < len) {
+        uint32_t pos  = offset + (uint32_t)done;
+        uint32_t want = (uint32_t)(len - done);
+        int i = lz_find(kwad, pos);
+
+        // Hueco entre extensiones: ceros hasta la siguiente
+        if (i < 0 || pos >= kwad->ext[i].vpos + kwad->ext[i].vsize) {
+            uint32_t next = (uint32_t)(i + 1) < kwad->next ? kwad->ext[i + 1].vpos
+                                                           : kwad->wad.length;
+            uint32_t k = next - pos < want ? next - pos : want;
+            memset(dst + done, 0, k);
+            done += k;
+            continue;
+        }
+
+        const wadlz4_extent_t *e = &kwad->ext[i];
+        uint32_t in = pos - e->vpos;
+        uint32_t k  = e->vsize - in < want ? e->vsize - in : want;
+
+        if (e->csize == e->vsize) {                     // guardada sin comprimir
+            const byte *src = lz_fetch(kwad, e->cpos + in, k);
+            if (!src) break;
+            memcpy(dst + done, src, k);
+        } else if (in == 0 && k == e->vsize) {          // lump entero: directo al destino
+            if (!lz_inflate(kwad, e, dst + done)) break;
+        } else {
+            if (kwad->scratch_idx != i) {
+                if (kwad->scratch) Z_Free(kwad->scratch);
+                kwad->scratch = Z_Malloc(e->vsize, PU_STATIC, 0);
+                kwad->scratch_idx = -1;
+                if (!lz_inflate(kwad, e, kwad->scratch)) break;
+                kwad->scratch_idx = i;
+            }
+            memcpy(dst + done, kwad->scratch + in, k);
+        }
+        done += k;
+    }
+    return done;
+}
+
+// ---------- clase stdc_wad_file ----------
+
+static kernel_wad_file_t *W_Kernel_New(void){
+    kernel_wad_file_t *kwad = Z_Malloc(sizeof(kernel_wad_file_t), PU_STATIC, 0);
+    memset(kwad, 0, sizeof(*kwad));
+    kwad->wad.file_class = &stdc_wad_file;
+    kwad->scratch_idx = -1;
+    return kwad;
+}
+
+static void W_Kernel_Free(kernel_wad_file_t *kwad){
+    if (kwad->fstream) fclose(kwad->fstream);
+    else kfile_unmap(&kwad->map);
+    if (kwad->ext) Z_Free(kwad->ext);
+    if (kwad->scratch) Z_Free(kwad->scratch);
+    if (kwad->cbuf) Z_Free(kwad->cbuf);
+    Z_Free(kwad);
+}
+
+static wad_file_t *W_Kernel_OpenFile(char *path){
+    kernel_wad_file_t *result;
+    kfile_map_t map;
+    uint32_t csize;
+
+    if (kfile_map(path, &map) == 0) {
+        result = W_Kernel_New();
+        result->wad.mapped = (byte *)map.data;
+        result->wad.length = map.size;
+        result->map = map;
+        csize = map.size;
+    } else {
+        FILE *fstream = fopen(path, "rb");
+        if (fstream == NULL) return NULL;
+
+        result = W_Kernel_New();
+        result->wad.mapped = NULL;
+        result->wad.length = M_FileLength(fstream);
+        result->fstream = fstream;
+        csize = result->wad.length;
+    }
+
+    if (lz_open(result, csize) < 0) {
+        printf("W_Kernel_OpenFile: %s: WAD LZ4 corrupto\n", path);
+        W_Kernel_Free(result);
+        return NULL;
+    }
+    return &result->wad;
+}
+
+static void W_Kernel_CloseFile(wad_file_t *wad){
+    W_Kernel_Free((kernel_wad_file_t *)wad);
+}
+
+// Cabecera y directorio siguen pasando por aquí; los lumps no (mapped != NULL)
+static size_t W_Kernel_Read(wad_file_t *wad, unsigned int offset,
+                            void *buffer, size_t buffer_len){
+    kernel_wad_file_t *kwad = (kernel_wad_file_t *)wad;
+
+    if (kwad->ext != NULL) return lz_read(kwad, offset, buffer, buffer_len);
+
+    if (wad->mapped != NULL) {
+        if (offset >= wad->length) return 0;
+        if (buffer_len > wad->length - offset) buffer_len = wad->length - offset;
+        memcpy(buffer, wad->mapped + offset, buffer_len);
+        return buffer_len;
+    }
+
+    fseek(kwad->fstream, offset, SEEK_SET);
+    return fread(buffer, 1, buffer_len, kwad->fstream);
+}
+
+wad_file_class_t stdc_wad_file = {
+    W_Kernel_OpenFile,
+    W_Kernel_CloseFile,
+    W_Kernel_Read,
+};
@@ -0,0 +1,169 @@
+/**
+ * @file w_prefetch.c
+ * @brief Precarga en segundo plano del siguiente mapa mientras Doom espera
+ *
+ * Se ejecuta como tarea de idle (kernel/idle.h), es decir, en los huecos de
+ * I_Sleep entre tics y en las esperas de teclado. Averigua qué mapa se
+ * cargará a continuación (el inicial en la pantalla de título y las demos,
+ * wminfo.next en el intermedio, gamemap + 1 durante la partida) y trae a la
+ * zona con PU_CACHE sus lumps, los flats de sus sectores y las texturas de
+ * sus sidedefs (compuestas vía R_GetColumn). Cuando P_SetupLevel pide esos
+ * lumps con PU_STATIC, W_CacheLumpNum sólo cambia la etiqueta del bloque.
+ *
+ * Cada pasada trabaja como mucho PF_BUDGET_US microsegundos para no retrasar
+ * el siguiente tic. Con un WAD precargado entero (wad->mapped) los lumps ya
+ * están en memoria y sólo se ahorra la composición de texturas.
+ */
+#include <stdint.h>
+#include <string.h>
+
+#include "doomtype.h"
+#include "doomdata.h"
+#include "doomstat.h"
+#include "m_argv.h"
+#include "m_misc.h"
+#include "r_data.h"
+#include "w_wad.h"
+#include "z_zone.h"
+
+#include <arch/x86/tsc.h>
+
+#define PF_BUDGET_US    1000
+
+extern int  firstflat, numflats;
+extern int  numtextures;
+extern int *texturewidthmask;
+
+typedef enum {
+    PF_LUMPS,           /* lumps del mapa, de ML_THINGS a ML_BLOCKMAP */
+    PF_SECTORS,         /* flats de suelo y techo */
+    PF_SIDEDEFS,        /* marca las texturas usadas */
+    PF_TEXTURES,        /* compone las texturas marcadas */
+    PF_DONE,
+} pf_stage_t;
+
+static int        pf_disabled = -1;     /* -1: sin consultar -noprefetch */
+static int        pf_map = -1;          /* lump marcador del mapa en curso */
+static pf_stage_t pf_stage;
+static int        pf_idx;
+static uint8_t*   pf_used;              /* bitmap de texturas, numtextures bits */
+
+// Mapa que se cargará después, o -1 si no se puede saber
+static int PF_NextMap(void){
+    int ep, map;
+    char name[9];
+
+    if (demoplayback || gamestate == GS_DEMOSCREEN) {
+        ep = startepisode; map = startmap;
+    } else if (gamestate == GS_INTERMISSION) {
+        ep = wminfo.epsd + 1; map = wminfo.next + 1;
+    } else if (gamestate == GS_LEVEL) {
+        ep = gameepisode; map = gamemap + 1;
+        if (gamemode != commercial && map > 8) return -1;   // fin de episodio
+    } else {
+        return -1;
+    }
+
+    if (gamemode == commercial) M_snprintf(name, sizeof(name), "MAP%02d", map);
+    else                        M_snprintf(name, sizeof(name), "E%dM%d", ep, map);
+    int lump = W_CheckNumForName(name);
+    return (lump >= 0 && (unsigned)lump + ML_BLOCKMAP < numlumps) ? lump : -1;
+}
+
+static void PF_Start(int lump){
+    pf_map   = lump;
+    pf_stage = PF_LUMPS;
+    pf_idx   = 0;
+    if (!pf_used) pf_used = Z_Malloc((numtextures + 7) / 8, PU_STATIC, 0);
+    memset(pf_used, 0, (numtextures + 7) / 8);
+}
+
+static void PF_CacheFlat(const char* name){
+    char n[9];
+    memcpy(n, name, 8);
+    n[8] = 0;
+    int lump = W_CheckNumForName(n);
+    if (lump >= firstflat && lump < firstflat + numflats) W_CacheLumpNum(lump, PU_CACHE);
+}
+
+static void PF_MarkTexture(char* name){
+    int tex = R_CheckTextureNumForName(name);
+    if (tex > 0) pf_used[tex >> 3] |= (uint8_t)(1u << (tex & 7));   // 0 = "-" o la textura nula
+}
+
+// Un paso de trabajo; devuelve 0 cuando ya no queda nada para este mapa
+static int PF_Step(void){
+    switch (pf_stage) {
+        case PF_LUMPS:
+            W_CacheLumpNum(pf_map + ML_THINGS + pf_idx, PU_CACHE);
+            if (++pf_idx > ML_BLOCKMAP - ML_THINGS) { pf_stage = PF_SECTORS; pf_idx = 0; }
+            return 1;
+
+        case PF_SECTORS: {
+            // Se vuelve a pedir en cada paso: un bloque PU_CACHE puede purgarse entre pasadas
+            int lump = pf_map + ML_SECTORS;
+            int n = W_LumpLength(lump) / sizeof(mapsector_t);
+            if (pf_idx < n) {
+                // Copia de los nombres: cargar el flat puede purgar el propio SECTORS
+                const mapsector_t* ms = (const mapsector_t*)W_CacheLumpNum(lump, PU_CACHE) + pf_idx;
+                char floorpic[8], ceilingpic[8];
+                memcpy(floorpic, ms->floorpic, 8);
+                memcpy(ceilingpic, ms->ceilingpic, 8);
+                PF_CacheFlat(floorpic);
+                PF_CacheFlat(ceilingpic);
+                pf_idx++;
+            } else {
+                pf_stage = PF_SIDEDEFS; pf_idx = 0;
+            }
+            return 1;
+        }
+
+        case PF_SIDEDEFS: {
+            int lump = pf_map + ML_SIDEDEFS;
+            int n = W_LumpLength(lump) / sizeof(mapsidedef_t);
+            if (pf_idx < n) {
+                // Igual que en SECTORS: nada de punteros al bloque PU_CACHE entre llamadas
+                const mapsidedef_t* msd = (const mapsidedef_t*)W_CacheLumpNum(lump, PU_CACHE) + pf_idx;
+                char top[8], bottom[8], mid[8];
+                memcpy(top, msd->toptexture, 8);
+                memcpy(bottom, msd->bottomtexture, 8);
+                memcpy(mid, msd->midtexture, 8);
+                PF_MarkTexture(top);
+                PF_MarkTexture(bottom);
+                PF_MarkTexture(mid);
+                pf_idx++;
+            } else {
+                pf_stage = PF_TEXTURES; pf_idx = 0;
+            }
+            return 1;
+        }
+
+        case PF_TEXTURES:
+            while (pf_idx < numtextures && !(pf_used[pf_idx >> 3] & (1u << (pf_idx & 7)))) pf_idx++;
+            if (pf_idx < numtextures) {
+                // Cada columna trae su parche o, si es compuesta, genera la textura entera
+                for (int col = 0; col <= texturewidthmask[pf_idx]; col++) R_GetColumn(pf_idx, col);
+                pf_idx++;
+            } else {
+                pf_stage = PF_DONE;
+            }
+            return 1;
+
+        case PF_DONE:
+            break;
+    }
+    return 0;
+}
+
+void W_PrefetchIdle(void){
+    if (pf_disabled < 0) pf_disabled = M_CheckParm("-noprefetch") != 0;
+    if (pf_disabled || numtextures <= 0) return;       // R_Init todavía no ha terminado
+
+    int lump = PF_NextMap();
+    if (lump < 0) return;
+    if (lump != pf_map) PF_Start(lump);
+
+    uint64_t budget = (uint64_t)tsc_khz() * PF_BUDGET_US / 1000;
+    uint64_t t0 = rdtsc();
+    while (PF_Step() && rdtsc() - t0 < budget) { }
+}
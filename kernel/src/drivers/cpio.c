@@ -4,6 +4,9 @@
  */
 #include <drivers/cpio.h>
 #include <string.h>
+#include <stdlib.h>
+
+#define CPIO_HDR_SIZE 110
 
 static uint32_t hx8(const char *s) { // 8 hex chars -> uint32
     uint32_t v=0;
@@ -40,4 +43,165 @@ const void* cpio_find(const void *cpio, uint32_t size, const char *path, uint32_
         p = (const uint8_t*)align4((uint32_t)(uintptr_t)(data + filesize));
     }
     return NULL;
-}
\ No newline at end of file
+}
+
+// --------- Índice hash ---------
+
+// Quita "./" y "/" iniciales para que "a/b", "./a/b" y "/a/b" coincidan
+static const char* norm_path(const char* s){
+    for (;;) {
+        if (s[0] == '/') { s++; continue; }
+        if (s[0] == '.' && s[1] == '/') { s += 2; continue; }
+        if (s[0] == '.' && s[1] == 0) return s + 1;
+        return s;
+    }
+}
+
+// FNV-1a sobre los primeros 'n' bytes (n = longitud sin '/' final)
+static uint32_t path_hash(const char* s, size_t n){
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++) { h ^= (uint8_t)s[i]; h *= 16777619u; }
+    return h;
+}
+
+static size_t path_len(const char* s){
+    size_t n = strlen(s);
+    while (n > 0 && s[n-1] == '/') n--;
+    return n;
+}
+
+// Walk de la imagen: llama a 'fn' por cada entrada válida. Devuelve nº de entradas.
+typedef void (*cpio_visit_fn)(void* ctx, const char* name, const void* data,
+                              uint32_t size, uint32_t mode);
+
+static uint32_t cpio_walk(const void* cpio, uint32_t size, cpio_visit_fn fn, void* ctx){
+    const uint8_t *p = (const uint8_t*)cpio;
+    const uint8_t *end = p + size;
+    uint32_t n = 0;
+    while (p + CPIO_HDR_SIZE <= end) {
+        if (memcmp(p, "070701", 6) != 0) break;
+        uint32_t mode     = hx8((const char*)p+14);   // c_mode
+        uint32_t filesize = hx8((const char*)p+54);   // c_filesize
+        uint32_t namesize = hx8((const char*)p+94);   // c_namesize
+        const uint8_t *name = p + CPIO_HDR_SIZE;
+        if (namesize == 0 || name + namesize > end) break;
+        const char *nstr = (const char*)name;
+        if (strcmp(nstr, "TRAILER!!!") == 0) break;
+
+        const uint8_t *data = (const uint8_t*)align4((uint32_t)(uintptr_t)(name + namesize));
+        if (data + filesize > end) break;
+
+        const char* np = norm_path(nstr);
+        if (*np) {                                    // "." (raíz) no se indexa
+            if (fn) fn(ctx, np, data, filesize, mode);
+            n++;
+        }
+        p = (const uint8_t*)align4((uint32_t)(uintptr_t)(data + filesize));
+    }
+    return n;
+}
+
+static void index_insert(void* ctx, const char* name, const void* data,
+                         uint32_t size, uint32_t mode){
+    cpio_index_t* idx = (cpio_index_t*)ctx;
+    size_t   n = path_len(name);
+    uint32_t h = path_hash(name, n);
+
+    // Sondeo lineal; una ruta repetida (p.ej. cpio concatenados) reemplaza a
+    // la anterior en su sitio, para que el directorio padre la liste una vez
+    uint32_t b = h & idx->mask;
+    while (idx->buckets[b]) {
+        cpio_entry_t* o = &idx->entries[idx->buckets[b] - 1];
+        if (o->hash == h && path_len(o->name) == n && strncmp(o->name, name, n) == 0) {
+            o->name = name;
+            o->data = data;
+            o->size = size;
+            o->mode = mode;
+            return;
+        }
+        b = (b + 1) & idx->mask;
+    }
+
+    cpio_entry_t* e = &idx->entries[idx->count];
+    e->name = name;
+    e->data = data;
+    e->size = size;
+    e->mode = mode;
+    e->hash = h;
+    e->first_child  = CPIO_NONE;
+    e->next_sibling = CPIO_NONE;
+    idx->buckets[b] = idx->count + 1;
+    idx->count++;
+}
+
+static const cpio_entry_t* lookup_n(const cpio_index_t* idx, const char* path, size_t n){
+    uint32_t h = path_hash(path, n);
+    uint32_t b = h & idx->mask;
+    while (idx->buckets[b]) {
+        const cpio_entry_t* e = &idx->entries[idx->buckets[b] - 1];
+        if (e->hash == h && strncmp(e->name, path, n) == 0 && path_len(e->name) == n)
+            return e;
+        b = (b + 1) & idx->mask;
+    }
+    return NULL;
+}
+
+int cpio_index_build(cpio_index_t* idx, const void* cpio, uint32_t size){
+    memset(idx, 0, sizeof(*idx));
+    idx->root_first = CPIO_NONE;
+
+    uint32_t total = cpio_walk(cpio, size, NULL, NULL);
+    uint32_t nb = 16;
+    while (nb < total * 2) nb <<= 1;             // factor de carga <= 0.5
+
+    idx->entries = (cpio_entry_t*)malloc((total ? total : 1) * sizeof(cpio_entry_t));
+    idx->buckets = (uint32_t*)calloc(nb, sizeof(uint32_t));
+    if (!idx->entries || !idx->buckets) { cpio_index_free(idx); return -1; }
+    idx->mask = nb - 1;
+
+    cpio_walk(cpio, size, index_insert, idx);
+
+    // Enlaza cada entrada con su directorio padre (listado sin recorrer la imagen)
+    for (uint32_t i = idx->count; i-- > 0; ) {
+        cpio_entry_t* e = &idx->entries[i];
+        size_t n = path_len(e->name);
+        size_t slash = n;
+        while (slash > 0 && e->name[slash-1] != '/') slash--;
+        cpio_entry_t* parent = slash ? (cpio_entry_t*)lookup_n(idx, e->name, slash - 1) : NULL;
+        uint32_t* head = parent ? &parent->first_child : &idx->root_first;
+        e->next_sibling = *head;
+        *head = i;
+    }
+    return (int)idx->count;
+}
+
+void cpio_index_free(cpio_index_t* idx){
+    free(idx->entries);
+    free(idx->buckets);
+    memset(idx, 0, sizeof(*idx));
+    idx->root_first = CPIO_NONE;
+}
+
+const cpio_entry_t* cpio_lookup(const cpio_index_t* idx, const char* path){
+    if (!idx->buckets) return NULL;
+    const char* p = norm_path(path);
+    return lookup_n(idx, p, path_len(p));
+}
+
+const cpio_entry_t* cpio_dir_next(const cpio_index_t* idx, const char* dir, uint32_t* cookie){
+    uint32_t next;
+    if (*cookie == 0) {
+        const char* d = norm_path(dir);
+        if (*d == 0) next = idx->root_first;
+        else {
+            const cpio_entry_t* e = cpio_lookup(idx, d);
+            if (!e || (e->mode & CPIO_MODE_TYPE) != CPIO_MODE_DIR) return NULL;
+            next = e->first_child;
+        }
+    } else {
+        next = idx->entries[*cookie - 1].next_sibling;
+    }
+    if (next == CPIO_NONE) { *cookie = 0; return NULL; }
+    *cookie = next + 1;
+    return &idx->entries[next];
+}
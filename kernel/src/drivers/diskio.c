@@ -0,0 +1,69 @@
+/**
+ * @file diskio.c
+ * @brief Capa diskio de FatFs sobre el disco RAM (unidad 0)
+ *
+ * Sustituye al diskio.o de libfatfs.a, que leía de una imagen FAT12
+ * embebida en el binario. Al definir aquí todas las funciones disk_* y
+ * get_fattime el enlazador ya no extrae ese objeto de la biblioteca.
+ */
+#include <fatfs/ff.h>
+#include <fatfs/diskio.h>
+#include <drivers/ramdisk.h>
+#include <drivers/rtc.h>
+#include <kernel/iostat.h>
+
+#define DEV_RAM 0
+
+DSTATUS disk_status(BYTE pdrv){
+    if (pdrv != DEV_RAM) return STA_NOINIT;
+    return ramdisk_present() ? 0 : (STA_NOINIT | STA_NODISK);
+}
+
+DSTATUS disk_initialize(BYTE pdrv){
+    return disk_status(pdrv);
+}
+
+DRESULT disk_read(BYTE pdrv, BYTE* buff, LBA_t sector, UINT count){
+    if (pdrv != DEV_RAM || !count) return RES_PARERR;
+    if (!ramdisk_present()) return RES_NOTRDY;
+    uint64_t t0 = rdtsc();
+    if (ramdisk_read(buff, (uint32_t)sector, count) != 0) return RES_PARERR;
+    iostat_read(&iostat_dev, (size_t)count * RAMDISK_SECTOR_SIZE, t0);
+    return RES_OK;
+}
+
+#if FF_FS_READONLY == 0
+DRESULT disk_write(BYTE pdrv, const BYTE* buff, LBA_t sector, UINT count){
+    if (pdrv != DEV_RAM || !count) return RES_PARERR;
+    if (!ramdisk_present()) return RES_NOTRDY;
+    uint64_t t0 = rdtsc();
+    if (ramdisk_write(buff, (uint32_t)sector, count) != 0) return RES_PARERR;
+    iostat_write(&iostat_dev, (size_t)count * RAMDISK_SECTOR_SIZE, t0);
+    return RES_OK;
+}
+#endif
+
+DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void* buff){
+    if (pdrv != DEV_RAM) return RES_PARERR;
+    if (!ramdisk_present()) return RES_NOTRDY;
+    switch (cmd) {
+    case CTRL_SYNC:        return RES_OK;   // RAM: nada pendiente
+    case GET_SECTOR_COUNT: *(LBA_t*)buff = ramdisk_sectors(); return RES_OK;
+    case GET_SECTOR_SIZE:  *(WORD*)buff  = RAMDISK_SECTOR_SIZE; return RES_OK;
+    case GET_BLOCK_SIZE:   *(DWORD*)buff = 1; return RES_OK;
+    default:               return RES_PARERR;
+    }
+}
+
+/* Hora del RTC extendida con el TSC (drivers/rtc.h), sin leer el CMOS */
+DWORD get_fattime(void){
+    rtc_time_t t;
+    rtc_from_epoch((uint32_t)(rtc_now_us() / 1000000u), &t);
+    if (t.year < 1980) t.year = 1980;           // FAT no representa fechas anteriores
+    return ((DWORD)(t.year - 1980) << 25)
+         | ((DWORD)t.mon << 21)
+         | ((DWORD)t.mday << 16)
+         | ((DWORD)t.hour << 11)
+         | ((DWORD)t.min << 5)
+         | ((DWORD)t.sec >> 1);
+}
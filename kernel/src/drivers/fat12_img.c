@@ -1 +0,0 @@
-#include <disk/fat12_img.h>
\ No newline at end of file
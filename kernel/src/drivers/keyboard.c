@@ -4,6 +4,8 @@
  */
 #include <drivers/keyboard.h>
 #include <arch/x86/io.h>
+#include <arch/x86/tsc.h>
+#include <kernel/ring.h>
 #include <stdint.h>
 #include <stdio.h>
 
@@ -15,20 +17,24 @@
 #define PIC1_DATA       0x21
 #define PIC_EOI         0x20
 
-// --------- Buffer de teclado ---------
+// --------- Buffer de teclado (ISR → consola) ---------
 static char kbd_buf[KBD_BUF_SIZE];
-static volatile unsigned kbd_head=0, kbd_tail=0;
+static ring_t kbd_ring = RING_INIT(kbd_buf, 1, KBD_BUF_SIZE);
 
 static void kbd_put(char c) {
-    unsigned next = (kbd_head + 1) % KBD_BUF_SIZE;
-    if (next != kbd_tail) { kbd_buf[kbd_head] = c; kbd_head = next; }
+    ring_push(&kbd_ring, &c);
 }
 
-static int kbd_get(void) { // -1 si vacío
-    if (kbd_head == kbd_tail) return -1;
-    char c = kbd_buf[kbd_tail];
-    kbd_tail = (kbd_tail + 1) % KBD_BUF_SIZE;
-    return (int)c;
+// --------- Cola de eventos (pulsar/soltar con marca de tiempo) ---------
+static kbd_event_t kbd_evq[KBD_EVQ_SIZE];
+static ring_t kbd_ev_ring = RING_INIT(kbd_evq, sizeof(kbd_event_t), KBD_EVQ_SIZE);
+
+static void kbd_ev_put(uint16_t sc, uint8_t pressed, uint64_t tsc) {
+    uint32_t n = 1;
+    kbd_event_t* ev = (kbd_event_t*)ring_reserve(&kbd_ev_ring, &n);
+    if (!n) { kbd_ev_ring.dropped++; return; }
+    *ev = (kbd_event_t){ sc, pressed, tsc };
+    ring_commit(&kbd_ev_ring, 1);
 }
 
 // --------- Estado de modificadores ---------
@@ -130,18 +136,40 @@ void kbd_init(void) {
 
 void kbd_isr(void) {
     uint8_t status = inb(KBD_STATUS_PORT);
-    // Bit 0 = Output buffer full
-    if (status & 1) {
-        static int seen_e0 = 0; // ignoramos extendidos por simplicidad
+    // Bit 0 = Output buffer full; bit 5 = el byte es del ratón (lo recoge IRQ12)
+    if ((status & 1) && !(status & 0x20)) {
+        static int seen_e0 = 0;     // el byte anterior era el prefijo 0xE0
+        static int skip_e1 = 0;     // bytes restantes de la secuencia de Pausa
+        uint64_t now = rdtsc();
         uint8_t sc = inb(KBD_DATA_PORT);
 
+        if (skip_e1) { skip_e1--; goto eoi; }
+        if (sc == 0xE1) {           // Pausa: E1 1D 45 E1 9D C5, no tiene soltado propio
+            skip_e1 = 5;
+            kbd_ev_put(KBD_SC_PAUSE, 1, now);
+            kbd_ev_put(KBD_SC_PAUSE, 0, now);
+            goto eoi;
+        }
         if (sc == 0xE0) { seen_e0 = 1; goto eoi; } // extendido (teclas cursores, etc.)
+
+        int ext = seen_e0;
+        seen_e0 = 0;
+        uint8_t make = sc & 0x7F;
+        // E0 2A / E0 36 son mayúsculas "falsas" que acompañan a Impr Pant y al bloque de cursores
+        if (ext && (make == 0x2A || make == 0x36)) goto eoi;
+        kbd_ev_put((uint16_t)(ext ? (KBD_SC_EXT | make) : make), !(sc & 0x80), now);
+
         if (sc & 0x80) { // break (soltada)
-            uint8_t make = sc & 0x7F;
-            if (make == 0x2A) s_left_shift  = 0;   // LShift
-            if (make == 0x36) s_right_shift = 0;   // RShift
+            if (!ext && make == 0x2A) s_left_shift  = 0;   // LShift
+            if (!ext && make == 0x36) s_right_shift = 0;   // RShift
             // ignorar otras
         } else { // make (pulsada)
+            if (ext) {
+                // Del bloque extendido sólo producen texto Intro y '/' del teclado numérico
+                if (sc == 0x1C) kbd_put('\n');
+                if (sc == 0x35) kbd_put('/');
+                goto eoi;
+            }
             if (sc == 0x2A) { s_left_shift  = 1; goto eoi; }   // LShift
             if (sc == 0x36) { s_right_shift = 1; goto eoi; }   // RShift
             if (sc == 0x3A) { s_caps ^= 1;       goto eoi; }   // CapsLock (toggle)
@@ -171,16 +199,19 @@ eoi:
     outb(PIC1_CMD, PIC_EOI);
 }
 
-int kbd_getchar(void) {
-    return kbd_get();
+int kbd_getchar(void) { // -1 si vacío
+    unsigned char c;
+    return ring_pop(&kbd_ring, &c) == 0 ? c : -1;
 }
 
 size_t kbd_read(char *dst, size_t max) {
-    size_t n = 0;
-    while (n < max) {
-        int c = kbd_get();
-        if (c < 0) break;
-        dst[n++] = (char)c;
-    }
-    return n;
-}
\ No newline at end of file
+    return ring_read(&kbd_ring, dst, (uint32_t)max);
+}
+
+size_t kbd_read_events(kbd_event_t *dst, size_t max) {
+    return ring_read(&kbd_ev_ring, dst, (uint32_t)max);
+}
+
+uint32_t kbd_events_dropped(void) {
+    return kbd_ev_ring.dropped;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file mouse.c
+ * @brief Implementación del driver de ratón PS/2 (paquetes de 3/4 bytes)
+ */
+#include <drivers/mouse.h>
+#include <arch/x86/io.h>
+#include <arch/x86/idt.h>
+#include <arch/x86/tsc.h>
+
+#define KBC_DATA        0x60
+#define KBC_STATUS      0x64    // lectura
+#define KBC_CMD         0x64    // escritura
+
+#define KBC_ST_OBF      0x01    // hay byte para leer
+#define KBC_ST_IBF      0x02    // el controlador aún no ha recogido el último
+#define KBC_ST_AUX      0x20    // el byte viene del ratón
+
+#define KBC_READ_CFG    0x20
+#define KBC_WRITE_CFG   0x60
+#define KBC_AUX_ENABLE  0xA8
+#define KBC_TO_AUX      0xD4    // el siguiente byte de datos va al ratón
+
+#define CFG_AUX_IRQ     0x02
+#define CFG_AUX_CLKOFF  0x20
+
+#define MS_SET_RATE     0xF3
+#define MS_GET_ID       0xF2
+#define MS_DEFAULTS     0xF6
+#define MS_ENABLE       0xF4
+#define MS_ACK          0xFA
+
+#define PKT_SYNC        0x08    // bit 3 del primer byte, siempre a 1
+#define PKT_XSIGN       0x10
+#define PKT_YSIGN       0x20
+#define PKT_OVERFLOW    0xC0
+
+#define PIC1_CMD        0x20
+#define PIC2_CMD        0xA0
+#define PIC_EOI         0x20
+
+#define KBC_TIMEOUT     100000
+
+static int      g_present = 0;
+static int      g_pkt_len = 3;
+static uint8_t  g_pkt[4];
+static int      g_pkt_pos = 0;
+
+// Estado acumulado por la ISR (se lee con interrupciones deshabilitadas)
+static volatile int32_t  g_dx, g_dy, g_dz;
+static volatile uint8_t  g_buttons, g_last_buttons;
+static volatile uint32_t g_packets;
+static volatile uint64_t g_tsc;
+
+static int kbc_wait_write(void) {
+    for (int i = 0; i < KBC_TIMEOUT; i++)
+        if (!(inb(KBC_STATUS) & KBC_ST_IBF)) return 0;
+    return -1;
+}
+
+static int kbc_read(void) {
+    for (int i = 0; i < KBC_TIMEOUT; i++)
+        if (inb(KBC_STATUS) & KBC_ST_OBF) return inb(KBC_DATA);
+    return -1;
+}
+
+static int kbc_cmd(uint8_t cmd) {
+    if (kbc_wait_write() < 0) return -1;
+    outb(KBC_CMD, cmd);
+    return 0;
+}
+
+static int kbc_data(uint8_t v) {
+    if (kbc_wait_write() < 0) return -1;
+    outb(KBC_DATA, v);
+    return 0;
+}
+
+// Comando al ratón; devuelve 0 si responde ACK
+static int ms_cmd(uint8_t cmd) {
+    if (kbc_cmd(KBC_TO_AUX) < 0 || kbc_data(cmd) < 0) return -1;
+    return kbc_read() == MS_ACK ? 0 : -1;
+}
+
+static int ms_set_rate(uint8_t hz) {
+    return (ms_cmd(MS_SET_RATE) < 0 || ms_cmd(hz) < 0) ? -1 : 0;
+}
+
+int mouse_init(void) {
+    while (inb(KBC_STATUS) & KBC_ST_OBF) (void)inb(KBC_DATA);   // vaciar restos
+
+    if (kbc_cmd(KBC_AUX_ENABLE) < 0 || kbc_cmd(KBC_READ_CFG) < 0) return -1;
+    int cfg = kbc_read();
+    if (cfg < 0) return -1;
+    cfg = (cfg | CFG_AUX_IRQ) & ~CFG_AUX_CLKOFF;
+    if (kbc_cmd(KBC_WRITE_CFG) < 0 || kbc_data((uint8_t)cfg) < 0) return -1;
+
+    if (ms_cmd(MS_DEFAULTS) < 0) return -1;
+
+    // Secuencia mágica de IntelliMouse: 200, 100, 80 Hz y el ID pasa a 3 (rueda)
+    g_pkt_len = 3;
+    if (ms_set_rate(200) == 0 && ms_set_rate(100) == 0 && ms_set_rate(80) == 0 &&
+        ms_cmd(MS_GET_ID) == 0 && kbc_read() == 3)
+        g_pkt_len = 4;
+    ms_set_rate(100);
+
+    if (ms_cmd(MS_ENABLE) < 0) return -1;
+
+    g_pkt_pos = 0;
+    g_present = 1;
+    pic_unmask(2);      // cascada al PIC esclavo
+    pic_unmask(12);
+    return 0;
+}
+
+int mouse_present(void) {
+    return g_present;
+}
+
+static void mouse_packet(uint64_t now) {
+    uint8_t b0 = g_pkt[0];
+    if (b0 & PKT_OVERFLOW) return;              // delta no fiable: se descarta
+    int32_t dx = (int32_t)g_pkt[1] - ((b0 & PKT_XSIGN) ? 256 : 0);
+    int32_t dy = (int32_t)g_pkt[2] - ((b0 & PKT_YSIGN) ? 256 : 0);
+    g_dx += dx;
+    g_dy += dy;
+    if (g_pkt_len == 4) g_dz += (int8_t)(g_pkt[3] << 4) >> 4;   // 4 bits con signo
+    g_buttons = b0 & (MOUSE_BTN_LEFT | MOUSE_BTN_RIGHT | MOUSE_BTN_MIDDLE);
+    g_packets++;
+    g_tsc = now;
+}
+
+void mouse_isr(void) {
+    uint8_t st = inb(KBC_STATUS);
+    if ((st & (KBC_ST_OBF | KBC_ST_AUX)) == (KBC_ST_OBF | KBC_ST_AUX)) {
+        uint8_t b = inb(KBC_DATA);
+        // Resincroniza si el primer byte no lleva el bit 3
+        if (g_pkt_pos == 0 && !(b & PKT_SYNC)) goto eoi;
+        g_pkt[g_pkt_pos++] = b;
+        if (g_pkt_pos == g_pkt_len) {
+            g_pkt_pos = 0;
+            mouse_packet(rdtsc());
+        }
+    }
+eoi:
+    outb(PIC2_CMD, PIC_EOI);
+    outb(PIC1_CMD, PIC_EOI);
+}
+
+int mouse_poll(mouse_state_t* out) {
+    uint32_t flags;
+    __asm__ __volatile__("pushf; pop %0; cli" : "=r"(flags) :: "memory");
+    out->dx = g_dx; out->dy = g_dy; out->dz = g_dz;
+    out->buttons = g_buttons;
+    out->packets = g_packets;
+    out->tsc = g_tsc;
+    g_dx = g_dy = g_dz = 0;
+    g_packets = 0;
+    int changed = out->dx || out->dy || out->dz || g_buttons != g_last_buttons;
+    g_last_buttons = g_buttons;
+    __asm__ __volatile__("push %0; popf" :: "r"(flags) : "memory", "cc");
+    return changed;
+}
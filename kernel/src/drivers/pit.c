@@ -4,6 +4,7 @@
  */
 #include <drivers/pit.h>
 #include <arch/x86/io.h>
+#include <kernel/thread.h>
 
 // PIT (8253/8254) ports
 #define PIT_CH0_DATA    0x40
@@ -16,11 +17,13 @@
 
 // Contador global de ticks
 volatile uint32_t pit_ticks = 0;
+static uint32_t g_pit_hz = 0;
 
 void pit_init(uint32_t hz) {
     // Calcular divisor para la frecuencia deseada
     uint32_t divisor = PIT_FREQ / hz;
     if (divisor > 65535) divisor = 65535;
+    g_pit_hz = PIT_FREQ / divisor;
     
     // Modo 3 (square wave), acceso 16-bit, canal 0
     outb(PIT_MODE_CMD, 0x36);
@@ -30,10 +33,17 @@ void pit_init(uint32_t hz) {
     outb(PIT_CH0_DATA, (uint8_t)(divisor >> 8));
 }
 
+uint32_t pit_hz(void) {
+    return g_pit_hz;
+}
+
 void pit_isr(void) {
     // Incrementar contador de ticks
     pit_ticks++;
     
     // Enviar EOI al PIC maestro
     outb(PIC1_CMD, PIC_EOI);
+
+    // Después del EOI: sched_tick puede cambiar de hilo sin volver aquí hasta más tarde
+    sched_tick();
 }
\ No newline at end of file
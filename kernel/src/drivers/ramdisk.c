@@ -0,0 +1,47 @@
+/**
+ * @file ramdisk.c
+ * @brief Disco en RAM sobre un módulo Multiboot
+ */
+#include <drivers/ramdisk.h>
+#include <kernel/multiboot.h>
+#include <string.h>
+
+static uint8_t* g_base = NULL;
+static uint32_t g_sectors = 0;
+
+void ramdisk_attach(void* base, uint32_t size){
+    g_base    = (uint8_t*)base;
+    g_sectors = base ? size / RAMDISK_SECTOR_SIZE : 0;
+}
+
+int ramdisk_init_from_modules(void){
+    const boot_module_t* m = mb_find_module("ramdisk");
+    if (!m && mb_module_count() == 1) m = mb_module(0);
+    if (!m || m->size < RAMDISK_SECTOR_SIZE) return -1;
+    ramdisk_attach((void*)m->base, m->size);
+    return 0;
+}
+
+int ramdisk_present(void){ return g_sectors != 0; }
+uint32_t ramdisk_sectors(void){ return g_sectors; }
+
+static int in_range(uint32_t lba, uint32_t count){
+    return g_base && lba < g_sectors && count <= g_sectors - lba;
+}
+
+int ramdisk_read(void* dst, uint32_t lba, uint32_t count){
+    if (!in_range(lba, count)) return -1;
+    memcpy(dst, g_base + (size_t)lba * RAMDISK_SECTOR_SIZE, (size_t)count * RAMDISK_SECTOR_SIZE);
+    return 0;
+}
+
+int ramdisk_write(const void* src, uint32_t lba, uint32_t count){
+    if (!in_range(lba, count)) return -1;
+    memcpy(g_base + (size_t)lba * RAMDISK_SECTOR_SIZE, src, (size_t)count * RAMDISK_SECTOR_SIZE);
+    return 0;
+}
+
+const void* ramdisk_map(uint32_t lba, uint32_t count){
+    if (!in_range(lba, count)) return NULL;
+    return g_base + (size_t)lba * RAMDISK_SECTOR_SIZE;
+}
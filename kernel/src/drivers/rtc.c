@@ -0,0 +1,118 @@
+/**
+ * @file rtc.c
+ * @brief Implementación del driver del RTC CMOS
+ *
+ * Se supone que el CMOS guarda la hora en UTC (como QEMU por defecto) y
+ * que el año pertenece al siglo XXI: no se consulta el registro de siglo
+ * de ACPI.
+ */
+#include <drivers/rtc.h>
+#include <drivers/pit.h>
+#include <arch/x86/io.h>
+#include <arch/x86/tsc.h>
+
+#define CMOS_INDEX  0x70
+#define CMOS_DATA   0x71
+#define CMOS_NMI_OFF 0x80   // bit 7 del índice: mantener NMI deshabilitada
+
+#define RTC_SEC     0x00
+#define RTC_MIN     0x02
+#define RTC_HOUR    0x04
+#define RTC_MDAY    0x07
+#define RTC_MON     0x08
+#define RTC_YEAR    0x09
+#define RTC_STA     0x0A
+#define RTC_STB     0x0B
+
+#define STA_UIP     0x80    // actualización en curso
+#define STB_24H     0x02
+#define STB_BIN     0x04    // binario en vez de BCD
+#define HOUR_PM     0x80    // en modo 12 h
+
+#define RTC_FALLBACK_EPOCH 1735689600u  // 2025-01-01 00:00:00 UTC
+
+static uint64_t g_base_us = (uint64_t)RTC_FALLBACK_EPOCH * 1000000u;  // hora al leer el CMOS
+static uint64_t g_base_tsc;
+static uint32_t g_base_ticks;
+
+static uint8_t cmos_read(uint8_t reg) {
+    outb(CMOS_INDEX, CMOS_NMI_OFF | reg);
+    return inb(CMOS_DATA);
+}
+
+static void cmos_snapshot(uint8_t r[6]) {
+    while (cmos_read(RTC_STA) & STA_UIP) { }
+    r[0] = cmos_read(RTC_SEC);
+    r[1] = cmos_read(RTC_MIN);
+    r[2] = cmos_read(RTC_HOUR);
+    r[3] = cmos_read(RTC_MDAY);
+    r[4] = cmos_read(RTC_MON);
+    r[5] = cmos_read(RTC_YEAR);
+}
+
+static uint8_t bcd(uint8_t v) { return (uint8_t)((v >> 4) * 10 + (v & 0x0F)); }
+
+// Días desde 1970-01-01 (algoritmo de H. Hinnant, calendario gregoriano)
+static int32_t days_from_civil(int32_t y, uint32_t m, uint32_t d) {
+    y -= m <= 2;
+    int32_t era = (y >= 0 ? y : y - 399) / 400;
+    uint32_t yoe = (uint32_t)(y - era * 400);
+    uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+void rtc_from_epoch(uint32_t secs, rtc_time_t* t) {
+    uint32_t days = secs / 86400, rem = secs % 86400;
+    t->hour = (uint8_t)(rem / 3600);
+    t->min  = (uint8_t)(rem / 60 % 60);
+    t->sec  = (uint8_t)(rem % 60);
+
+    uint32_t z = days + 719468;
+    uint32_t era = z / 146097;
+    uint32_t doe = z - era * 146097;
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+    t->mday = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+    t->mon  = (uint8_t)m;
+    t->year = (uint16_t)(yoe + era * 400 + (m <= 2));
+}
+
+int rtc_init(void) {
+    uint8_t a[6], b[6];
+
+    // Dos lecturas iguales seguidas: ninguna actualización se coló en medio
+    cmos_snapshot(b);
+    do {
+        for (int i = 0; i < 6; i++) a[i] = b[i];
+        cmos_snapshot(b);
+    } while (a[0] != b[0] || a[1] != b[1] || a[2] != b[2] ||
+             a[3] != b[3] || a[4] != b[4] || a[5] != b[5]);
+    g_base_tsc   = rdtsc();
+    g_base_ticks = pit_ticks;
+
+    uint8_t stb = cmos_read(RTC_STB);
+    uint8_t pm  = b[2] & HOUR_PM;
+    b[2] &= (uint8_t)~HOUR_PM;
+    if (!(stb & STB_BIN))
+        for (int i = 0; i < 6; i++) b[i] = bcd(b[i]);
+    if (!(stb & STB_24H)) b[2] = (uint8_t)(b[2] % 12 + (pm ? 12 : 0));
+
+    if (b[0] > 59 || b[1] > 59 || b[2] > 23 || b[3] < 1 || b[3] > 31 ||
+        b[4] < 1 || b[4] > 12 || b[5] > 99)
+        return -1;                              // se queda RTC_FALLBACK_EPOCH
+
+    int32_t days = days_from_civil(2000 + b[5], b[4], b[3]);
+    uint32_t secs = (uint32_t)days * 86400u + b[2] * 3600u + b[1] * 60u + b[0];
+    g_base_us = (uint64_t)secs * 1000000u;
+    return 0;
+}
+
+uint64_t rtc_now_us(void) {
+    if (tsc_khz()) return g_base_us + tsc_to_us(rdtsc() - g_base_tsc);
+    uint32_t hz = pit_hz();
+    uint64_t ticks = pit_ticks - g_base_ticks;
+    return g_base_us + (hz ? ticks * 1000000u / hz : 0);
+}
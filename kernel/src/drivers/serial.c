@@ -0,0 +1,64 @@
+/**
+ * @file serial.c
+ * @brief Implementación del driver 16550 (sin interrupciones)
+ */
+#include <drivers/serial.h>
+#include <arch/x86/io.h>
+
+// Registros relativos al puerto base
+#define UART_DATA   0   // THR/RBR (DLL con DLAB=1)
+#define UART_IER    1   // (DLM con DLAB=1)
+#define UART_FCR    2
+#define UART_LCR    3
+#define UART_MCR    4
+#define UART_LSR    5
+
+#define LSR_DR      0x01    // dato recibido
+#define LSR_THRE    0x20    // THR vacío
+
+#define UART_CLOCK  115200
+
+static uint16_t g_port = 0;
+
+int serial_init(uint16_t port, uint32_t baud) {
+    uint16_t div = (uint16_t)(UART_CLOCK / (baud ? baud : UART_CLOCK));
+    if (!div) div = 1;
+
+    outb(port + UART_IER, 0x00);                // sin interrupciones
+    outb(port + UART_LCR, 0x80);                // DLAB
+    outb(port + UART_DATA, (uint8_t)(div & 0xFF));
+    outb(port + UART_IER,  (uint8_t)(div >> 8));
+    outb(port + UART_LCR, 0x03);                // 8N1
+    outb(port + UART_FCR, 0xC7);                // FIFO on, limpiar, umbral 14
+    outb(port + UART_MCR, 0x1E);                // loopback para la prueba
+
+    // Si no hay UART, el byte no vuelve
+    outb(port + UART_DATA, 0xAE);
+    if (inb(port + UART_DATA) != 0xAE) { g_port = 0; return -1; }
+
+    outb(port + UART_MCR, 0x0F);                // modo normal: DTR, RTS, OUT1, OUT2
+    g_port = port;
+    return 0;
+}
+
+int serial_present(void) {
+    return g_port != 0;
+}
+
+void serial_putc(char c) {
+    if (!g_port) return;
+    while (!(inb(g_port + UART_LSR) & LSR_THRE)) { }
+    outb(g_port + UART_DATA, (uint8_t)c);
+}
+
+void serial_write(const char* s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (s[i] == '\n') serial_putc('\r');
+        serial_putc(s[i]);
+    }
+}
+
+int serial_getc(void) {
+    if (!g_port || !(inb(g_port + UART_LSR) & LSR_DR)) return -1;
+    return inb(g_port + UART_DATA);
+}
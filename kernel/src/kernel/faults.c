@@ -1,6 +1,10 @@
 // src/kernel/faults.c — manejadores C para faults/IRQ de diagnóstico
 #include <stdint.h>
 #include <stdio.h>
+#include <arch/x86/faults.h>
+#include <arch/x86/paging.h>
+#include <kernel/vm.h>
+#include <kernel/thread.h>
 
 static void hex32(uint32_t x){
     const char*h="0123456789ABCDEF";
@@ -19,6 +23,20 @@ void fault_handler(uint32_t vec, uint32_t err){
     for(;;) __asm__ __volatile__("hlt");
 }
 
+/* #PF: primero los mapeos bajo demanda; si no es nuestro, volcado y parada */
+void pf_handler(uint32_t vec, uint32_t err){
+    uint32_t cr2 = read_cr2();
+    if (vm_handle_fault(cr2, err)) return;
+    printf("\n#PF cr2="); hex32(cr2);
+    fault_handler(vec, err);
+}
+
+/* #NM: cambio perezoso de FPU entre hilos; con TS=0 es un fallo de verdad */
+void nm_handler(void){
+    if (thread_handle_nm()) return;
+    fault_handler(7, 0);
+}
+
 /* #MF (x87 FP error): leer CW/SW/TW con FNSTENV, limpiar y (si quieres) continuar.
    De momento mostramos info y nos paramos para depurar. */
 struct fenv16 {
@@ -0,0 +1,68 @@
+/**
+ * @file filemap.c
+ * @brief Región contigua con el contenido de un fichero (initrd, módulo o FatFs)
+ */
+#include <kernel/filemap.h>
+#include <kernel/initrd.h>
+#include <kernel/multiboot.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char* base_name(const char* path){
+    const char* b = path;
+    for (const char* p = path; *p; p++) if (*p == '/' || *p == ':') b = p + 1;
+    return b;
+}
+
+static int map_borrowed(kfile_map_t* m, const void* data, uint32_t size){
+    m->data  = (const uint8_t*)data;
+    m->size  = size;
+    m->owned = 0;
+    return 0;
+}
+
+int kfile_map(const char* path, kfile_map_t* m){
+    memset(m, 0, sizeof(*m));
+
+    const char* sub = initrd_subpath(path);
+    if (sub) {
+        const cpio_entry_t* e = initrd_lookup(sub);
+        if (!e || (e->mode & CPIO_MODE_TYPE) == CPIO_MODE_DIR) { errno = ENOENT; return -1; }
+        return map_borrowed(m, e->data, e->size);
+    }
+
+    const boot_module_t* mod = mb_find_module(base_name(path));
+    if (mod) return map_borrowed(m, mod->base, mod->size);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) < 0) { close(fd); return -1; }
+
+    uint8_t* buf = (uint8_t*)malloc(st.st_size ? (size_t)st.st_size : 1);
+    if (!buf) { close(fd); errno = ENOMEM; return -1; }
+
+    // Una sola petición: FatFs lee los sectores completos directamente en 'buf'
+    size_t got = 0;
+    while (got < (size_t)st.st_size) {
+        ssize_t r = read(fd, buf + got, (size_t)st.st_size - got);
+        if (r <= 0) break;
+        got += (size_t)r;
+    }
+    close(fd);
+    if (got != (size_t)st.st_size) { free(buf); errno = EIO; return -1; }
+
+    m->data  = buf;
+    m->size  = (uint32_t)got;
+    m->owned = 1;
+    return 0;
+}
+
+void kfile_unmap(kfile_map_t* m){
+    if (m->owned) free((void*)m->data);
+    memset(m, 0, sizeof(*m));
+}
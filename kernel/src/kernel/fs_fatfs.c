@@ -0,0 +1,391 @@
+/**
+ * @file fs_fatfs.c
+ * @brief Backend VFS de FatFs sobre el disco RAM (unidad 0, montado en la raíz)
+ *
+ * El volumen se monta en el primer open/unlink/rename/mkdir; las
+ * operaciones sobre un fichero ya abierto no vuelven a comprobarlo.
+ */
+#include <kernel/vfs.h>
+#include <kernel/idle.h>      // defer_call(), idle_register()
+#include <kernel/vm.h>        // vm_map_file()
+#include <drivers/pit.h>      // pit_ticks
+#include <fatfs/ff.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static FATFS g_fs;
+static int g_mounted = 0;
+
+static int ensure_mounted(void) {
+    if (g_mounted) return 0;
+    FRESULT fr = f_mount(&g_fs, "", 0);
+    if (fr == FR_OK) { g_mounted = 1; return 0; }
+    errno = EIO;
+    return -1;
+}
+
+static int ff_to_errno(FRESULT fr) {
+    switch (fr) {
+    case FR_OK: return 0;
+    case FR_NO_FILE: case FR_NO_PATH: return ENOENT;
+    case FR_INVALID_NAME: return EINVAL;
+    case FR_EXIST: return EEXIST;
+    case FR_DENIED: return EACCES;
+    case FR_NOT_READY: return EBUSY;
+    case FR_INVALID_OBJECT: return EBADF;
+    case FR_DISK_ERR: case FR_INT_ERR: return EIO;
+    case FR_WRITE_PROTECTED: return EROFS;
+    case FR_NOT_ENABLED: case FR_NO_FILESYSTEM: return ENODEV;
+    case FR_TOO_MANY_OPEN_FILES: return EMFILE;
+    default: return EIO;
+    }
+}
+
+typedef struct fat_file {
+    FIL f;
+    int append;
+    // Write-back (abierto para escritura): ver "write-back" más abajo
+    uint8_t* wb;            // bloque que se está llenando (NULL = sin reservar)
+    uint32_t wb_len;
+    uint32_t wb_cap;        // 0 = escritura directa
+    FSIZE_t  wb_off;        // offset en el fichero de wb[0]
+    uint32_t wb_tick;       // pit_ticks del primer byte pendiente
+    uint32_t wb_inflight;   // bloques encolados aún no escritos
+    int      wb_err;        // errno de una escritura diferida fallida
+    struct fat_file* next;  // lista de abiertos (volcado en idle)
+} fat_file_t;
+
+static fat_file_t* g_open = NULL;
+
+// ---------- write-back ----------
+// Las escrituras pequeñas (p.ej. p_saveg.c) se juntan en bloques de un
+// cluster. Un bloque lleno se encola y lo escribe defer_drain()/idle_run()
+// fuera del tic; lo que quede a medias se vuelca al cerrar, en fsync o
+// cuando lleva WB_IDLE_TICKS sin tocarse. Mientras hay datos pendientes la
+// posición lógica del fichero es wb_off + wb_len y f.fptr va por detrás: el
+// resto de operaciones llaman antes a wb_sync().
+#if !FF_FS_READONLY
+#define WB_MIN_CAP     4096
+#define WB_IDLE_TICKS  50           // 0,5 s con el PIT a 100 Hz
+
+typedef struct {
+    fat_file_t* e;
+    FSIZE_t     off;
+    uint32_t    len;
+    uint8_t*    data;
+} wb_chunk_t;
+
+static inline int wb_pending(const fat_file_t* e){ return e->wb_len || e->wb_inflight; }
+
+// Escribe [off, off+len) en el fichero; un fallo queda en wb_err para la próxima llamada
+static void wb_store(fat_file_t* e, FSIZE_t off, const uint8_t* data, uint32_t len){
+    FRESULT fr = FR_OK;
+    UINT bw = 0;
+    if (e->f.fptr != off) fr = f_lseek(&e->f, off);
+    if (fr == FR_OK) fr = f_write(&e->f, data, len, &bw);
+    if (e->wb_err) return;
+    if (fr != FR_OK)     e->wb_err = ff_to_errno(fr);
+    else if (bw < len)   e->wb_err = ENOSPC;
+}
+
+// Se ejecuta en contexto diferido: bloques de un mismo fichero salen en orden (FIFO)
+static void wb_chunk_write(void* arg){
+    wb_chunk_t* c = (wb_chunk_t*)arg;
+    wb_store(c->e, c->off, c->data, c->len);
+    c->e->wb_inflight--;
+    free(c->data);
+    free(c);
+}
+
+// Entrega el bloque actual a la cola diferida (o lo escribe ya si no hay memoria)
+static void wb_queue(fat_file_t* e){
+    if (!e->wb_len) return;
+    wb_chunk_t* c = (wb_chunk_t*)malloc(sizeof(*c));
+    if (!c) {
+        defer_drain();                  // los bloques anteriores primero
+        wb_store(e, e->wb_off, e->wb, e->wb_len);
+    } else {
+        c->e = e; c->off = e->wb_off; c->len = e->wb_len; c->data = e->wb;
+        e->wb = NULL;                   // el siguiente bloque se reserva de nuevo
+        e->wb_inflight++;
+        if (defer_call(wb_chunk_write, c) < 0) {
+            defer_drain();              // cola llena: se vacía en orden antes de escribir
+            wb_chunk_write(c);
+        }
+    }
+    e->wb_off += e->wb_len;
+    e->wb_len = 0;
+}
+
+// Vuelca todo lo pendiente; deja f.fptr en la posición lógica
+static int wb_sync(fat_file_t* e){
+    if (wb_pending(e)) {
+        wb_queue(e);
+        defer_drain();
+    }
+    if (e->wb_err) { errno = e->wb_err; e->wb_err = 0; return -1; }
+    return 0;
+}
+
+// Tarea de idle: bloques a medio llenar que llevan un rato quietos
+static void wb_idle(void){
+    for (fat_file_t* e = g_open; e; e = e->next)
+        if (e->wb_len && (uint32_t)(pit_ticks - e->wb_tick) >= WB_IDLE_TICKS) wb_queue(e);
+}
+
+static ssize_t wb_write(fat_file_t* e, const void* buf, size_t count){
+    if (e->wb_err) { errno = e->wb_err; e->wb_err = 0; return -1; }
+    if (!wb_pending(e)) {
+        // Tras una escritura propia ya estamos en EOF: sólo se busca si alguien movió fptr
+        if (e->append && e->f.fptr != f_size(&e->f)) f_lseek(&e->f, f_size(&e->f));
+        e->wb_off = e->f.fptr;
+        // Un bloque entero no gana nada pasando por el buffer
+        if (count >= e->wb_cap) {
+            UINT bw = 0;
+            FRESULT fr = f_write(&e->f, buf, (UINT)count, &bw);
+            if (fr != FR_OK) { errno = ff_to_errno(fr); return -1; }
+            return (ssize_t)bw;
+        }
+    }
+    const uint8_t* src = (const uint8_t*)buf;
+    size_t left = count;
+    while (left) {
+        if (!e->wb) {
+            e->wb = (uint8_t*)malloc(e->wb_cap);
+            if (!e->wb) { errno = ENOMEM; return count - left ? (ssize_t)(count - left) : -1; }
+        }
+        if (!e->wb_len) e->wb_tick = pit_ticks;
+        size_t k = e->wb_cap - e->wb_len;
+        if (k > left) k = left;
+        memcpy(e->wb + e->wb_len, src, k);
+        e->wb_len += (uint32_t)k;
+        src += k; left -= k;
+        if (e->wb_len == e->wb_cap) wb_queue(e);
+    }
+    return (ssize_t)count;
+}
+#else
+static inline int wb_sync(fat_file_t* e){ (void)e; return 0; }
+#endif
+
+// ---------- ops de fichero ----------
+static ssize_t fat_read(vfs_file_t* vf, void* buf, size_t count){
+    fat_file_t* e = (fat_file_t*)vf->priv;
+    if (wb_sync(e) < 0) return -1;
+    UINT br = 0;
+    FRESULT fr = f_read(&e->f, buf, (UINT)count, &br);
+    if (fr != FR_OK) { errno = ff_to_errno(fr); return -1; }
+    return (ssize_t)br;
+}
+
+static ssize_t fat_write(vfs_file_t* vf, const void* buf, size_t count){
+#if FF_FS_READONLY
+    (void)vf; (void)buf; (void)count;
+    errno = EROFS; return -1;
+#else
+    fat_file_t* e = (fat_file_t*)vf->priv;
+    if (e->wb_cap) return wb_write(e, buf, count);
+    if (e->append && e->f.fptr != f_size(&e->f)) f_lseek(&e->f, f_size(&e->f));
+    UINT bw = 0;
+    FRESULT fr = f_write(&e->f, buf, (UINT)count, &bw);
+    if (fr != FR_OK) { errno = ff_to_errno(fr); return -1; }
+    return (ssize_t)bw;
+#endif
+}
+
+static off_t fat_lseek(vfs_file_t* vf, off_t offset, int whence){
+    fat_file_t* e = (fat_file_t*)vf->priv;
+    if (wb_sync(e) < 0) return -1;
+
+    FSIZE_t base = 0;
+    switch (whence) {
+        case SEEK_SET: base = 0; break;
+        case SEEK_CUR: base = e->f.fptr; break;
+        case SEEK_END: base = f_size(&e->f); break;
+        default: errno = EINVAL; return -1;
+    }
+    if (offset < 0 && (FSIZE_t)(-offset) > base) { errno = EINVAL; return -1; }
+    FSIZE_t pos = base + (FSIZE_t)offset;
+
+    FRESULT fr = f_lseek(&e->f, pos);
+    if (fr != FR_OK) { errno = ff_to_errno(fr); return -1; }
+    return (off_t)e->f.fptr;
+}
+
+// pread/pwrite no mueven la posición del fichero
+static ssize_t fat_pread(vfs_file_t* vf, void* buf, size_t count, off_t offset){
+    fat_file_t* e = (fat_file_t*)vf->priv;
+    if (wb_sync(e) < 0) return -1;
+    FSIZE_t saved = e->f.fptr;
+    FRESULT fr = FR_OK;
+    if ((FSIZE_t)offset != saved) fr = f_lseek(&e->f, (FSIZE_t)offset);
+    UINT br = 0;
+    if (fr == FR_OK) fr = f_read(&e->f, buf, (UINT)count, &br);
+    if (e->f.fptr != saved) f_lseek(&e->f, saved);
+    if (fr != FR_OK) { errno = ff_to_errno(fr); return -1; }
+    return (ssize_t)br;
+}
+
+static ssize_t fat_pwrite(vfs_file_t* vf, const void* buf, size_t count, off_t offset){
+#if FF_FS_READONLY
+    (void)vf; (void)buf; (void)count; (void)offset;
+    errno = EROFS; return -1;
+#else
+    fat_file_t* e = (fat_file_t*)vf->priv;
+    if (wb_sync(e) < 0) return -1;
+    FSIZE_t saved = e->f.fptr;
+    FRESULT fr = FR_OK;
+    if ((FSIZE_t)offset != saved) fr = f_lseek(&e->f, (FSIZE_t)offset);
+    UINT bw = 0;
+    if (fr == FR_OK) fr = f_write(&e->f, buf, (UINT)count, &bw);
+    if (e->f.fptr != saved) f_lseek(&e->f, saved);
+    if (fr != FR_OK) { errno = ff_to_errno(fr); return -1; }
+    return (ssize_t)bw;
+#endif
+}
+
+static int fat_fstat(vfs_file_t* vf, struct stat* st){
+    fat_file_t* e = (fat_file_t*)vf->priv;
+    if (wb_sync(e) < 0) return -1;
+    memset(st, 0, sizeof(*st));
+    st->st_mode  = S_IFREG;
+    st->st_nlink = 1;
+    st->st_size  = (off_t)f_size(&e->f);
+    // Buffer de stdio recomendado (ver stdio_file.c): un cluster, mínimo 4 KiB, máximo 32 KiB
+    blksize_t bs = (blksize_t)g_fs.csize * FF_MAX_SS;
+    if (bs < 4096)  bs = 4096;
+    if (bs > 32768) bs = 32768;
+    st->st_blksize = bs;
+    return 0;
+}
+
+static int fat_fsync(vfs_file_t* vf){
+#if FF_FS_READONLY
+    (void)vf;
+    return 0;
+#else
+    fat_file_t* e = (fat_file_t*)vf->priv;
+    if (wb_sync(e) < 0) return -1;
+    FRESULT fr = f_sync(&e->f);
+    if (fr != FR_OK) { errno = ff_to_errno(fr); return -1; }
+    return 0;
+#endif
+}
+
+// Sólo lectura, paginado bajo demanda (ver vm.c)
+static void* fat_mmap(vfs_file_t* vf, size_t len, off_t off){
+    fat_file_t* e = (fat_file_t*)vf->priv;
+#if !FF_FS_READONLY
+    if (wb_sync(e) < 0) return NULL;
+    f_sync(&e->f);                                // la copia del FIL no debe heredar datos sucios
+#endif
+    return vm_map_file(&e->f, (uint32_t)off, (uint32_t)len);
+}
+
+static int fat_close(vfs_file_t* vf){
+    fat_file_t* e = (fat_file_t*)vf->priv;
+    int werr = wb_sync(e) < 0 ? errno : 0;
+    FRESULT fr = f_close(&e->f);
+    for (fat_file_t** p = &g_open; *p; p = &(*p)->next)
+        if (*p == e) { *p = e->next; break; }
+    free(e->wb);
+    free(e);
+    if (werr) { errno = werr; return -1; }
+    if (fr != FR_OK) { errno = ff_to_errno(fr); return -1; }
+    return 0;
+}
+
+static const vfs_file_ops_t FAT_FILE_OPS = {
+    .read   = fat_read,
+    .write  = fat_write,
+    .lseek  = fat_lseek,
+    .pread  = fat_pread,
+    .pwrite = fat_pwrite,
+    .fstat  = fat_fstat,
+    .fsync  = fat_fsync,
+    .mmap   = fat_mmap,
+    .close  = fat_close,
+};
+
+// ---------- ops del sistema de ficheros ----------
+static int fat_open(void* ctx, const char* path, int oflag, vfs_file_t* vf){
+    (void)ctx;
+    if (ensure_mounted() < 0) return -1;
+
+    BYTE acc = 0;
+    switch (oflag & O_ACCMODE) {
+        case O_RDONLY: acc |= FA_READ; break;
+        case O_WRONLY: acc |= FA_WRITE; break;
+        case O_RDWR:   acc |= (FA_READ | FA_WRITE); break;
+        default: errno = EINVAL; return -1;
+    }
+    if (oflag & O_CREAT) {
+#if FF_FS_READONLY
+        errno = EROFS; return -1;
+#else
+        if (oflag & O_EXCL)       acc |= FA_CREATE_NEW;
+        else if (oflag & O_TRUNC) acc |= FA_CREATE_ALWAYS;
+        else                      acc |= FA_OPEN_ALWAYS;
+#endif
+    } else {
+        acc |= FA_OPEN_EXISTING;
+    }
+
+    fat_file_t* e = (fat_file_t*)calloc(1, sizeof(*e));
+    if (!e) { errno = ENOMEM; return -1; }
+    FRESULT fr = f_open(&e->f, path, acc);
+    if (fr != FR_OK) { free(e); errno = ff_to_errno(fr); return -1; }
+
+    e->append = (oflag & O_APPEND) ? 1 : 0;
+    if (e->append) f_lseek(&e->f, f_size(&e->f));
+#if !FF_FS_READONLY
+    if ((oflag & O_ACCMODE) != O_RDONLY) {
+        e->wb_cap = (uint32_t)g_fs.csize * FF_MAX_SS;
+        if (e->wb_cap < WB_MIN_CAP) e->wb_cap = WB_MIN_CAP;
+        idle_register(wb_idle);
+    }
+#endif
+    e->next = g_open;
+    g_open = e;
+    vf->ops  = &FAT_FILE_OPS;
+    vf->priv = e;
+    return 0;
+}
+
+#if !FF_FS_READONLY
+static int fat_unlink(void* ctx, const char* path){
+    (void)ctx;
+    if (ensure_mounted() < 0) return -1;
+    FRESULT fr = f_unlink(path);
+    if (fr != FR_OK) { errno = ff_to_errno(fr); return -1; }
+    return 0;
+}
+
+static int fat_rename(void* ctx, const char* oldp, const char* newp){
+    (void)ctx;
+    if (ensure_mounted() < 0) return -1;
+    FRESULT fr = f_rename(oldp, newp);
+    if (fr != FR_OK) { errno = ff_to_errno(fr); return -1; }
+    return 0;
+}
+
+static int fat_mkdir(void* ctx, const char* path, mode_t mode){
+    (void)ctx; (void)mode;
+    if (ensure_mounted() < 0) return -1;
+    FRESULT fr = f_mkdir(path);
+    if (fr != FR_OK) { errno = ff_to_errno(fr); return -1; }
+    return 0;
+}
+#endif
+
+const vfs_fs_ops_t VFS_FATFS = {
+    .open   = fat_open,
+#if !FF_FS_READONLY
+    .unlink = fat_unlink,
+    .rename = fat_rename,
+    .mkdir  = fat_mkdir,
+#endif
+};
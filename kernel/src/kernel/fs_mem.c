@@ -0,0 +1,113 @@
+/**
+ * @file fs_mem.c
+ * @brief Ficheros en memoria de sólo lectura y el backend del initrd CPIO
+ *
+ * Los ficheros del initrd apuntan directamente dentro del módulo: read es
+ * un memcpy, mmap devuelve el puntero y no hay que comprobar montajes.
+ */
+#include <kernel/vfs.h>
+#include <kernel/initrd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const uint8_t* data;
+    uint32_t size;
+    uint32_t pos;
+    int      owned;
+} memfile_t;
+
+static ssize_t mem_pread(vfs_file_t* f, void* buf, size_t n, off_t off){
+    memfile_t* m = (memfile_t*)f->priv;
+    if ((uint32_t)off >= m->size) return 0;
+    uint32_t left = m->size - (uint32_t)off;
+    if (n > left) n = left;
+    memcpy(buf, m->data + off, n);
+    f->io->c.hits++;                            // nunca toca el dispositivo
+    return (ssize_t)n;
+}
+
+static ssize_t mem_read(vfs_file_t* f, void* buf, size_t n){
+    memfile_t* m = (memfile_t*)f->priv;
+    ssize_t r = mem_pread(f, buf, n, (off_t)m->pos);
+    m->pos += (uint32_t)r;
+    return r;
+}
+
+static off_t mem_lseek(vfs_file_t* f, off_t off, int whence){
+    memfile_t* m = (memfile_t*)f->priv;
+    uint32_t base;
+    switch (whence) {
+        case SEEK_SET: base = 0; break;
+        case SEEK_CUR: base = m->pos; break;
+        case SEEK_END: base = m->size; break;
+        default: errno = EINVAL; return -1;
+    }
+    if (off < 0 && (uint32_t)(-off) > base) { errno = EINVAL; return -1; }
+    uint32_t pos = base + (uint32_t)off;
+    m->pos = pos > m->size ? m->size : pos;
+    return (off_t)m->pos;
+}
+
+static int mem_fstat(vfs_file_t* f, struct stat* st){
+    memfile_t* m = (memfile_t*)f->priv;
+    memset(st, 0, sizeof(*st));
+    st->st_mode  = S_IFREG;
+    st->st_nlink = 1;
+    st->st_size  = (off_t)m->size;
+    return 0;
+}
+
+static void* mem_mmap(vfs_file_t* f, size_t len, off_t off){
+    (void)len;
+    memfile_t* m = (memfile_t*)f->priv;
+    if ((uint32_t)off >= m->size) { errno = EINVAL; return NULL; }
+    return (void*)(m->data + off);              // ya está en memoria
+}
+
+static int mem_close(vfs_file_t* f){
+    memfile_t* m = (memfile_t*)f->priv;
+    if (m->owned) free((void*)m->data);
+    free(m);
+    return 0;
+}
+
+static const vfs_file_ops_t MEMFILE_OPS = {
+    .read  = mem_read,
+    .lseek = mem_lseek,
+    .pread = mem_pread,
+    .fstat = mem_fstat,
+    .mmap  = mem_mmap,
+    .close = mem_close,
+};
+
+int vfs_memfile(vfs_file_t* f, const void* data, uint32_t size, int owned){
+    if ((f->oflag & O_ACCMODE) != O_RDONLY || (f->oflag & (O_CREAT|O_TRUNC|O_APPEND))) {
+        errno = EROFS; return -1;
+    }
+    memfile_t* m = (memfile_t*)malloc(sizeof(*m));
+    if (!m) { errno = ENOMEM; return -1; }
+    m->data  = (const uint8_t*)data;
+    m->size  = size;
+    m->pos   = 0;
+    m->owned = owned;
+    f->ops   = &MEMFILE_OPS;
+    f->priv  = m;
+    return 0;
+}
+
+// ---------- initrd ----------
+static int initrd_open(void* ctx, const char* path, int oflag, vfs_file_t* f){
+    (void)ctx; (void)oflag;
+    const cpio_entry_t* ce = initrd_lookup(path);
+    if (!ce) { errno = ENOENT; return -1; }
+    if ((ce->mode & CPIO_MODE_TYPE) == CPIO_MODE_DIR) { errno = EISDIR; return -1; }
+    return vfs_memfile(f, ce->data, ce->size, 0);
+}
+
+const vfs_fs_ops_t VFS_INITRD = {
+    .open = initrd_open,
+};
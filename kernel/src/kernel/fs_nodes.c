@@ -0,0 +1,177 @@
+/**
+ * @file fs_nodes.c
+ * @brief Sistema de ficheros de nodos fijos: /dev (tty, fb0, serial) y /sys (io)
+ */
+#include <kernel/vfs.h>
+#include <kernel/tty.h>
+#include <kernel/idle.h>
+#include <kernel/iostat.h>
+#include <drivers/serial.h>
+#include <drivers/video_vga13.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int nodes_open(void* ctx, const char* path, int oflag, vfs_file_t* f){
+    if (*path == 0) { errno = EISDIR; return -1; }
+    for (const vfs_node_t* n = (const vfs_node_t*)ctx; n->name; n++)
+        if (strcmp(n->name, path) == 0) return n->open(f, oflag);
+    errno = ENOENT;
+    return -1;
+}
+
+const vfs_fs_ops_t VFS_NODES = {
+    .open = nodes_open,
+};
+
+static int chr_fstat(vfs_file_t* f, struct stat* st){
+    (void)f;
+    memset(st, 0, sizeof(*st));
+    st->st_mode  = S_IFCHR;
+    st->st_nlink = 1;
+    return 0;
+}
+
+// ---------- /dev/fb0: framebuffer lineal del modo 13h ----------
+#define FB0_SIZE (VGA13_W * VGA13_H)
+
+typedef struct { uint32_t pos; } fb0_t;
+
+static ssize_t fb0_pread(vfs_file_t* f, void* buf, size_t n, off_t off){
+    (void)f;
+    if ((uint32_t)off >= FB0_SIZE) return 0;
+    if (n > FB0_SIZE - (uint32_t)off) n = FB0_SIZE - (uint32_t)off;
+    memcpy(buf, (const uint8_t*)VGA13_FB + off, n);
+    return (ssize_t)n;
+}
+
+static ssize_t fb0_pwrite(vfs_file_t* f, const void* buf, size_t n, off_t off){
+    (void)f;
+    if ((uint32_t)off >= FB0_SIZE) { errno = ENOSPC; return -1; }
+    if (n > FB0_SIZE - (uint32_t)off) n = FB0_SIZE - (uint32_t)off;
+    memcpy((uint8_t*)VGA13_FB + off, buf, n);
+    return (ssize_t)n;
+}
+
+static ssize_t fb0_read(vfs_file_t* f, void* buf, size_t n){
+    fb0_t* fb = (fb0_t*)f->priv;
+    ssize_t r = fb0_pread(f, buf, n, (off_t)fb->pos);
+    if (r > 0) fb->pos += (uint32_t)r;
+    return r;
+}
+
+static ssize_t fb0_write(vfs_file_t* f, const void* buf, size_t n){
+    fb0_t* fb = (fb0_t*)f->priv;
+    ssize_t w = fb0_pwrite(f, buf, n, (off_t)fb->pos);
+    if (w > 0) fb->pos += (uint32_t)w;
+    return w;
+}
+
+static off_t fb0_lseek(vfs_file_t* f, off_t off, int whence){
+    fb0_t* fb = (fb0_t*)f->priv;
+    uint32_t base;
+    switch (whence) {
+        case SEEK_SET: base = 0; break;
+        case SEEK_CUR: base = fb->pos; break;
+        case SEEK_END: base = FB0_SIZE; break;
+        default: errno = EINVAL; return -1;
+    }
+    if (off < 0 && (uint32_t)(-off) > base) { errno = EINVAL; return -1; }
+    fb->pos = base + (uint32_t)off;
+    return (off_t)fb->pos;
+}
+
+static int fb0_fstat(vfs_file_t* f, struct stat* st){
+    chr_fstat(f, st);
+    st->st_size = FB0_SIZE;
+    return 0;
+}
+
+// Identidad: el framebuffer ya es memoria direccionable
+static void* fb0_mmap(vfs_file_t* f, size_t len, off_t off){
+    (void)f;
+    if ((uint32_t)off >= FB0_SIZE || len > FB0_SIZE - (uint32_t)off) { errno = EINVAL; return NULL; }
+    return (void*)((uintptr_t)VGA13_FB + (uint32_t)off);
+}
+
+static int fb0_close(vfs_file_t* f){
+    free(f->priv);
+    return 0;
+}
+
+static const vfs_file_ops_t FB0_OPS = {
+    .read   = fb0_read,
+    .write  = fb0_write,
+    .lseek  = fb0_lseek,
+    .pread  = fb0_pread,
+    .pwrite = fb0_pwrite,
+    .fstat  = fb0_fstat,
+    .mmap   = fb0_mmap,
+    .close  = fb0_close,
+};
+
+static int fb0_open(vfs_file_t* f, int oflag){
+    (void)oflag;
+    fb0_t* fb = (fb0_t*)calloc(1, sizeof(*fb));
+    if (!fb) { errno = ENOMEM; return -1; }
+    f->ops  = &FB0_OPS;
+    f->priv = fb;
+    return 0;
+}
+
+// ---------- /dev/serial: COM1 ----------
+static ssize_t serial_read_op(vfs_file_t* f, void* buf, size_t n){
+    (void)f;
+    uint8_t* p = (uint8_t*)buf;
+    size_t got = 0;
+    while (got == 0 && n) {                     // bloquea hasta el primer byte
+        int c;
+        while (got < n && (c = serial_getc()) >= 0) p[got++] = (uint8_t)c;
+        if (got == 0) kernel_idle();
+    }
+    return (ssize_t)got;
+}
+
+static ssize_t serial_write_op(vfs_file_t* f, const void* buf, size_t n){
+    (void)f;
+    serial_write((const char*)buf, n);
+    return (ssize_t)n;
+}
+
+static const vfs_file_ops_t SERIAL_OPS = {
+    .read  = serial_read_op,
+    .write = serial_write_op,
+    .fstat = chr_fstat,
+};
+
+static int serial_open(vfs_file_t* f, int oflag){
+    (void)oflag;
+    if (!serial_present() && serial_init(SERIAL_COM1, 115200) < 0) { errno = ENODEV; return -1; }
+    f->ops = &SERIAL_OPS;
+    return 0;
+}
+
+// ---------- /sys/io: instantánea de los contadores en el momento del open ----------
+static int sys_io_open(vfs_file_t* f, int oflag){
+    if ((oflag & O_ACCMODE) != O_RDONLY) { errno = EACCES; return -1; }
+    size_t n = iostat_format(NULL, 0);
+    char* txt = (char*)malloc(n + 1);
+    if (!txt) { errno = ENOMEM; return -1; }
+    iostat_format(txt, n + 1);
+    if (vfs_memfile(f, txt, (uint32_t)n, 1) < 0) { free(txt); return -1; }
+    return 0;
+}
+
+const vfs_node_t VFS_DEV_NODES[] = {
+    { "tty",    tty_open },
+    { "fb0",    fb0_open },
+    { "serial", serial_open },
+    { NULL,     NULL },
+};
+
+const vfs_node_t VFS_SYS_NODES[] = {
+    { "io", sys_io_open },
+    { NULL, NULL },
+};
@@ -0,0 +1,95 @@
+/**
+ * @file idle.c
+ * @brief Cola de trabajo diferido y tareas de fondo
+ */
+#include <kernel/idle.h>
+#include <kernel/sync.h>
+#include <kernel/system.h>
+#include <kernel/thread.h>
+#include <stdint.h>
+
+typedef struct {
+    defer_fn_t fn;
+    void*      arg;
+} defer_item_t;
+
+typedef struct {
+    idle_hook_t fn;
+    thread_t*   owner;                      /* NULL: cualquier hilo */
+} idle_hook_item_t;
+
+// Cola y tabla de tareas con IF=0 (cambian desde cualquier hilo). g_run
+// ejecuta los trabajos de uno en uno; es recursivo porque un trabajo puede
+// llamar a defer_drain() (wb_queue sin memoria o con la cola llena).
+static defer_item_t     g_queue[DEFER_MAX];
+static uint32_t         g_head = 0, g_tail = 0;     /* g_tail - g_head = pendientes */
+static idle_hook_item_t g_hooks[IDLE_MAX_HOOKS];
+static int              g_nhooks = 0;
+static mutex_t          g_run = MUTEX_INIT_RECURSIVE;
+
+int defer_call(defer_fn_t fn, void* arg){
+    unsigned long flags = irq_save();
+    int r = -1;
+    if (g_tail - g_head < DEFER_MAX) {
+        g_queue[g_tail % DEFER_MAX] = (defer_item_t){ fn, arg };
+        g_tail++;
+        r = 0;
+    }
+    irq_restore(flags);
+    return r;
+}
+
+// Con g_run tomado. Un trabajo puede encolar otros: se saca el elemento antes de llamarlo
+static int defer_run_one(void){
+    unsigned long flags = irq_save();
+    if (g_head == g_tail) {
+        irq_restore(flags);
+        return 0;
+    }
+    defer_item_t it = g_queue[g_head % DEFER_MAX];
+    g_head++;
+    irq_restore(flags);
+    it.fn(it.arg);
+    return 1;
+}
+
+static int defer_run_all(void){
+    int n = 0;
+    mutex_lock(&g_run);
+    while (defer_run_one()) n++;
+    mutex_unlock(&g_run);
+    return n;
+}
+
+void defer_drain(void){
+    defer_run_all();
+}
+
+int idle_register(idle_hook_t hook){
+    thread_t* self = thread_current();
+    unsigned long flags = irq_save();
+    int found = 0;
+    for (int i = 0; i < g_nhooks && !found; i++)
+        found = g_hooks[i].fn == hook && g_hooks[i].owner == self;
+    int r = 0;
+    if (!found && g_nhooks >= IDLE_MAX_HOOKS) {
+        r = -1;
+    } else if (!found) {
+        g_hooks[g_nhooks] = (idle_hook_item_t){ hook, self };
+        __atomic_store_n(&g_nhooks, g_nhooks + 1, __ATOMIC_RELEASE);   // la entrada ya está escrita
+    }
+    irq_restore(flags);
+    return r;
+}
+
+int idle_run(void){
+    thread_t* self = thread_current();
+    int nhooks = __atomic_load_n(&g_nhooks, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < nhooks; i++)
+        if (!g_hooks[i].owner || g_hooks[i].owner == self) g_hooks[i].fn();
+    return defer_run_all();
+}
+
+void kernel_idle(void){
+    if (idle_run() == 0) thread_idle_wait();
+}
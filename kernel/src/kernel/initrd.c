@@ -0,0 +1,34 @@
+/**
+ * @file initrd.c
+ * @brief Índice del initrd CPIO construido una sola vez al arrancar
+ */
+#include <kernel/initrd.h>
+#include <kernel/multiboot.h>
+#include <string.h>
+
+static cpio_index_t g_idx;
+static int g_ready = 0;
+
+int initrd_init(void){
+    const boot_module_t* m = mb_find_module("initrd");
+    if (!m) return -1;
+    int n = cpio_index_build(&g_idx, m->base, m->size);
+    if (n < 0) return -1;
+    g_ready = 1;
+    return n;
+}
+
+const cpio_index_t* initrd_index(void){ return g_ready ? &g_idx : NULL; }
+
+const char* initrd_subpath(const char* path){
+    static const char mnt[] = INITRD_PREFIX;
+    size_t n = sizeof(mnt) - 2;                  // "/initrd" sin la barra final
+    if (strncmp(path, mnt, n) != 0) return NULL;
+    if (path[n] == 0) return path + n;           // "/initrd" = raíz del initrd
+    if (path[n] != '/') return NULL;
+    return path + n + 1;
+}
+
+const cpio_entry_t* initrd_lookup(const char* subpath){
+    return g_ready ? cpio_lookup(&g_idx, subpath) : NULL;
+}
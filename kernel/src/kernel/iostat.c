@@ -0,0 +1,86 @@
+/**
+ * @file iostat.c
+ * @brief Contadores de E/S y su resumen en texto (/sys/io)
+ */
+#include <kernel/iostat.h>
+#include <kernel/vm.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+io_counters_t iostat_dev;
+io_counters_t iostat_stdio;
+
+static iostat_file_t g_files[IOSTAT_MAX_FILES];
+static int           g_nfiles = 0;
+static iostat_file_t g_other = { "(otros)", 0, { 0 } };
+
+iostat_file_t* iostat_open(const char* path){
+    iostat_file_t* f = NULL;
+    for (int i = 0; i < g_nfiles; i++)
+        if (strncmp(g_files[i].path, path, IOSTAT_NAME_MAX - 1) == 0) { f = &g_files[i]; break; }
+    if (!f && g_nfiles < IOSTAT_MAX_FILES) {
+        f = &g_files[g_nfiles++];
+        strncpy(f->path, path, IOSTAT_NAME_MAX - 1);
+        f->path[IOSTAT_NAME_MAX - 1] = 0;
+    }
+    if (!f) f = &g_other;
+    f->opens++;
+    return f;
+}
+
+// ---- salida acotada estilo snprintf ----
+typedef struct { char* buf; size_t cap, len; } out_t;
+
+static void out(out_t* o, const char* fmt, ...){
+    va_list ap;
+    va_start(ap, fmt);
+    size_t room = o->len < o->cap ? o->cap - o->len : 0;
+    int n = vsnprintf(room ? o->buf + o->len : NULL, room, fmt, ap);
+    va_end(ap);
+    if (n > 0) o->len += (size_t)n;
+}
+
+static unsigned long us(uint64_t cycles){ return (unsigned long)tsc_to_us(cycles); }
+
+static void out_counters(out_t* o, const char* name, uint32_t opens, const io_counters_t* c){
+    out(o, "%-20s %5lu %7lu %10lu %9lu %7lu %10lu %9lu %6lu %9lu %7lu\n", name,
+        (unsigned long)opens,
+        (unsigned long)c->reads,  (unsigned long)c->rbytes, us(c->rcycles),
+        (unsigned long)c->writes, (unsigned long)c->wbytes, us(c->wcycles),
+        (unsigned long)c->seeks,  us(c->scycles),
+        (unsigned long)c->hits);
+}
+
+size_t iostat_format(char* buf, size_t cap){
+    out_t o = { buf, cap, 0 };
+    if (cap) buf[0] = 0;
+
+    out(&o, "tsc_khz %lu\n", (unsigned long)tsc_khz());
+    out(&o, "%-20s %5s %7s %10s %9s %7s %10s %9s %6s %9s %7s\n", "name", "opens",
+        "reads", "rbytes", "r_us", "writes", "wbytes", "w_us", "seeks", "s_us", "hits");
+    out_counters(&o, "[dev ram0]", 0, &iostat_dev);
+    out_counters(&o, "[stdio fread]", 0, &iostat_stdio);
+    for (int i = 0; i < g_nfiles; i++)
+        out_counters(&o, g_files[i].path, g_files[i].opens, &g_files[i].c);
+    if (g_other.opens)
+        out_counters(&o, g_other.path, g_other.opens, &g_other.c);
+
+    vm_stats_t vs;
+    vm_get_stats(&vs);
+    out(&o, "vm faults %lu evictions %lu resident %lu mappings %lu\n",
+        (unsigned long)vs.faults, (unsigned long)vs.evictions,
+        (unsigned long)vs.resident, (unsigned long)vs.mappings);
+    return o.len;
+}
+
+void iostat_dump(void){
+    size_t n = iostat_format(NULL, 0);
+    char* s = (char*)malloc(n + 1);
+    if (!s) return;
+    iostat_format(s, n + 1);
+    fputs(s, stdout);
+    fflush(stdout);
+    free(s);
+}
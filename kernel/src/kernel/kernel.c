@@ -1,10 +1,21 @@
 #include <kernel/console.h>
 #include <drivers/keyboard.h>
+#include <drivers/mouse.h>
 #include <kernel/system.h>
 #include <arch/x86/idt.h>
+#include <arch/x86/paging.h>
 #include <stdio.h>
 #include <arch/x86/io.h>
 #include <drivers/pit.h>
+#include <arch/x86/tsc.h>
+#include <drivers/rtc.h>
+#include <arch/x86/smp.h>
+#include <kernel/task.h>
+#include <kernel/thread.h>
+#include <drivers/ramdisk.h>
+#include <kernel/multiboot.h>
+#include <kernel/initrd.h>
+#include <kernel/vfs.h>
 
 extern int main(void);   // tu main() en src/main.c
 
@@ -12,12 +23,26 @@ static inline void soft_test_irq1(void){
     __asm__ __volatile__("int $0x21");
 }
 
-void kernel_main(void){
+void kernel_main(uint32_t mb_magic, uint32_t mb_info){
+    mb_init(mb_magic, mb_info);      // antes de tocar el heap: fija mb_reserved_end()
+    vfs_init();                      // montajes y fds 0/1/2 → /dev/tty
     interrupts_init();
+    paging_init();                   // identidad + ventana para mmap()
     console_init_all(&CONSOLE_TEXT, &STDIN_PS2, CONSOLE_STDIO_UNBUFFERED);
     kbd_set_layout(KBD_LAYOUT_ES);
+    mouse_init();                    // con IF=0: la ISR del teclado no debe robar las respuestas
     enable_interrupts();
     console_clear();
     pit_init(100);  // 100 Hz
+    tsc_calibrate(); // ciclos/ms para medir latencias
+    thread_init();                   // kernel_main pasa a ser el hilo "main"
+    if (rtc_init() < 0)              // hora de pared: CMOS una vez + TSC
+        printf("rtc: fecha CMOS invalida\n");
+    if (smp_init() > 1)              // datos por CPU en %fs; los AP quedan en hlt
+        printf("smp: %d CPUs\n", smp_cpu_count());
+    task_init();                     // los AP pasan a ejecutar tareas (parallel_for)
+    if (ramdisk_init_from_modules() < 0)
+        printf("ramdisk: no hay modulo cargado\n");
+    initrd_init();                   // opcional: módulo "initrd" (CPIO newc)
     main();
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+/**
+ * @file lathist.c
+ * @brief Histograma de latencias (ver kernel/lathist.h)
+ */
+#include <kernel/lathist.h>
+#include <arch/x86/tsc.h>
+#include <stdio.h>
+
+#define BAR_WIDTH 40
+
+void lathist_add(lathist_t* h, uint64_t cycles){
+    uint64_t us = tsc_to_us(cycles);
+    int b = 0;
+    while (b < LATHIST_BUCKETS - 1 && (us >> b)) b++;     // b = nº de bits de 'us'
+    h->bucket[b]++;
+    h->count++;
+    h->sum_us += us;
+    if (us > h->max_us) h->max_us = us;
+}
+
+// Cota superior (µs) de la cubeta donde cae el percentil 'pct'
+static uint64_t percentile(const lathist_t* h, uint32_t pct){
+    uint64_t want = ((uint64_t)h->count * pct + 99) / 100, acc = 0;
+    for (int b = 0; b < LATHIST_BUCKETS; b++) {
+        acc += h->bucket[b];
+        if (acc >= want) return (uint64_t)1 << b;
+    }
+    return h->max_us;
+}
+
+void lathist_dump(const lathist_t* h){
+    if (!h->count) { printf("%s: sin muestras\n", h->name); return; }
+    printf("%s: n %lu media %lu us p50 <%lu us p99 <%lu us max %lu us\n", h->name,
+           (unsigned long)h->count, (unsigned long)(h->sum_us / h->count),
+           (unsigned long)percentile(h, 50), (unsigned long)percentile(h, 99),
+           (unsigned long)h->max_us);
+
+    uint32_t peak = 0;
+    for (int b = 0; b < LATHIST_BUCKETS; b++) if (h->bucket[b] > peak) peak = h->bucket[b];
+    for (int b = 0; b < LATHIST_BUCKETS; b++) {
+        if (!h->bucket[b]) continue;
+        unsigned long lo = b ? 1ul << (b - 1) : 0;
+        char bar[BAR_WIDTH + 1];
+        int n = (int)((uint64_t)h->bucket[b] * BAR_WIDTH / peak);
+        if (!n) n = 1;
+        for (int i = 0; i < n; i++) bar[i] = '#';
+        bar[n] = 0;
+        if (b == LATHIST_BUCKETS - 1) printf("  %7lu-    ... us %6lu %s\n", lo, (unsigned long)h->bucket[b], bar);
+        else printf("  %7lu-%7lu us %6lu %s\n", lo, 1ul << b, (unsigned long)h->bucket[b], bar);
+    }
+}
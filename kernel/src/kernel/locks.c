@@ -0,0 +1,63 @@
+/**
+ * @file locks.c
+ * @brief Cerrojos de newlib (--enable-newlib-retargetable-locking) sobre mutex_t
+ *
+ * Al definir aquí todas las __retarget_lock_* y los cerrojos estáticos, el
+ * enlazador no trae los de relleno de libc.a (misc/lock.o). malloc, stdio,
+ * atexit y el entorno quedan protegidos entre hilos del kernel y entre
+ * CPUs (una tarea en un AP espera girando, ver sync.c); antes de
+ * thread_init() los mutex del BSP no hacen nada.
+ */
+#include <kernel/sync.h>
+#include <sys/lock.h>
+#include <errno.h>
+#include <stdlib.h>
+
+struct __lock {
+    mutex_t m;
+};
+
+struct __lock __lock___sinit_recursive_mutex  = { MUTEX_INIT_RECURSIVE };
+struct __lock __lock___sfp_recursive_mutex    = { MUTEX_INIT_RECURSIVE };
+struct __lock __lock___atexit_recursive_mutex = { MUTEX_INIT_RECURSIVE };
+struct __lock __lock___malloc_recursive_mutex = { MUTEX_INIT_RECURSIVE };
+struct __lock __lock___env_recursive_mutex    = { MUTEX_INIT_RECURSIVE };
+struct __lock __lock___at_quick_exit_mutex    = { MUTEX_INIT };
+struct __lock __lock___tz_mutex               = { MUTEX_INIT };
+struct __lock __lock___dd_hash_mutex          = { MUTEX_INIT };
+struct __lock __lock___arc4random_mutex       = { MUTEX_INIT };
+
+static void lock_new(_LOCK_T* lock, int recursive){
+    *lock = malloc(sizeof(struct __lock));
+    if (*lock) mutex_init(&(*lock)->m, recursive);
+}
+
+void __retarget_lock_init(_LOCK_T* lock)           { lock_new(lock, 0); }
+void __retarget_lock_init_recursive(_LOCK_T* lock) { lock_new(lock, 1); }
+void __retarget_lock_close(_LOCK_T lock)           { free(lock); }
+void __retarget_lock_close_recursive(_LOCK_T lock) { free(lock); }
+
+void __retarget_lock_acquire(_LOCK_T lock){
+    if (lock) mutex_lock(&lock->m);
+}
+
+void __retarget_lock_acquire_recursive(_LOCK_T lock){
+    if (lock) mutex_lock(&lock->m);
+}
+
+// Como ftrylockfile(): 0 si se ha tomado
+int __retarget_lock_try_acquire(_LOCK_T lock){
+    return (!lock || mutex_trylock(&lock->m)) ? 0 : EBUSY;
+}
+
+int __retarget_lock_try_acquire_recursive(_LOCK_T lock){
+    return (!lock || mutex_trylock(&lock->m)) ? 0 : EBUSY;
+}
+
+void __retarget_lock_release(_LOCK_T lock){
+    if (lock) mutex_unlock(&lock->m);
+}
+
+void __retarget_lock_release_recursive(_LOCK_T lock){
+    if (lock) mutex_unlock(&lock->m);
+}
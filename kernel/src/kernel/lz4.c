@@ -0,0 +1,60 @@
+/**
+ * @file lz4.c
+ * @brief Descompresor LZ4 (block format)
+ *
+ * Secuencia: token (4 bits literales | 4 bits match), longitud extra de
+ * literales, literales, offset de 16 bits LE, longitud extra del match.
+ * La última secuencia sólo lleva literales.
+ */
+#include <kernel/lz4.h>
+#include <string.h>
+
+// 15 en el nibble = la longitud sigue en bytes de 255 hasta uno menor
+static int read_len(const uint8_t** ip, const uint8_t* iend, uint32_t* len){
+    uint8_t b;
+    do {
+        if (*ip >= iend) return -1;
+        b = *(*ip)++;
+        *len += b;
+    } while (b == 255);
+    return 0;
+}
+
+int lz4_decompress(const uint8_t* src, uint32_t srclen, uint8_t* dst, uint32_t dstcap){
+    const uint8_t* ip   = src;
+    const uint8_t* iend = src + srclen;
+    uint8_t*       op   = dst;
+    uint8_t*       oend = dst + dstcap;
+
+    if (srclen == 0) return -1;
+    for (;;) {
+        uint8_t token = *ip++;
+
+        uint32_t lit = token >> 4;
+        if (lit == 15 && read_len(&ip, iend, &lit) < 0) return -1;
+        if (lit > (uint32_t)(iend - ip) || lit > (uint32_t)(oend - op)) return -1;
+        memcpy(op, ip, lit);
+        op += lit; ip += lit;
+        if (ip == iend) break;                      // última secuencia
+
+        if (iend - ip < 2) return -1;
+        uint32_t off = (uint32_t)ip[0] | ((uint32_t)ip[1] << 8);
+        ip += 2;
+        if (off == 0 || off > (uint32_t)(op - dst)) return -1;
+
+        uint32_t mlen = token & 15;
+        if (mlen == 15 && read_len(&ip, iend, &mlen) < 0) return -1;
+        mlen += 4;
+        if (mlen > (uint32_t)(oend - op)) return -1;
+
+        const uint8_t* m = op - off;
+        if (off >= mlen) {
+            memcpy(op, m, mlen);
+            op += mlen;
+        } else {
+            while (mlen--) *op++ = *m++;            // solapado: patrón repetido
+        }
+        if (ip >= iend) return -1;                  // falta la secuencia final
+    }
+    return (int)(op - dst);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file multiboot.c
+ * @brief Lectura de la información Multiboot1 entregada por Limine/GRUB
+ */
+#include <kernel/multiboot.h>
+#include <string.h>
+
+static boot_module_t g_mods[MB_MAX_MODULES];
+static char g_mod_names[MB_MAX_MODULES][64];
+static int g_mod_count = 0;
+
+static char g_cmdline[MB_CMDLINE_MAX];
+static uint32_t g_mem_upper = 0;
+static uintptr_t g_reserved_end = 0;
+
+static void copy_str(char* dst, size_t cap, const char* src){
+    size_t i = 0;
+    if (src) for (; i + 1 < cap && src[i]; i++) dst[i] = src[i];
+    dst[i] = 0;
+}
+
+static void reserve(uintptr_t end){
+    if (end > g_reserved_end) g_reserved_end = end;
+}
+
+int mb_init(uint32_t magic, uint32_t info){
+    if (magic != MB_BOOTLOADER_MAGIC || info == 0) return -1;
+    const mb_info_t* mbi = (const mb_info_t*)(uintptr_t)info;
+
+    if (mbi->flags & MB_INFO_MEMORY) g_mem_upper = mbi->mem_upper;
+    if (mbi->flags & MB_INFO_CMDLINE)
+        copy_str(g_cmdline, sizeof(g_cmdline), (const char*)(uintptr_t)mbi->cmdline);
+
+    if (mbi->flags & MB_INFO_MODS) {
+        const mb_module_t* m = (const mb_module_t*)(uintptr_t)mbi->mods_addr;
+        uint32_t n = mbi->mods_count;
+        if (n > MB_MAX_MODULES) n = MB_MAX_MODULES;
+        for (uint32_t i = 0; i < n; i++) {
+            if (m[i].mod_end < m[i].mod_start) continue;
+            boot_module_t* b = &g_mods[g_mod_count];
+            copy_str(g_mod_names[g_mod_count], sizeof(g_mod_names[0]),
+                     (const char*)(uintptr_t)m[i].string);
+            b->base    = (const void*)(uintptr_t)m[i].mod_start;
+            b->size    = m[i].mod_end - m[i].mod_start;
+            b->cmdline = g_mod_names[g_mod_count];
+            reserve(m[i].mod_end);
+            g_mod_count++;
+        }
+    }
+    return 0;
+}
+
+int mb_module_count(void){ return g_mod_count; }
+
+const boot_module_t* mb_module(int i){
+    return (i >= 0 && i < g_mod_count) ? &g_mods[i] : NULL;
+}
+
+const boot_module_t* mb_find_module(const char* name){
+    size_t n = strlen(name);
+    for (int i = 0; i < g_mod_count; i++) {
+        const char* s = g_mods[i].cmdline;
+        // La primera palabra de la cmdline identifica el módulo
+        if (strncmp(s, name, n) == 0 && (s[n] == 0 || s[n] == ' '))
+            return &g_mods[i];
+    }
+    return NULL;
+}
+
+const char* mb_cmdline(void){ return g_cmdline; }
+
+const char* mb_cmdline_opt(const char* key){
+    size_t n = strlen(key);
+    const char* s = g_cmdline;
+    while (*s) {
+        while (*s == ' ') s++;
+        if (strncmp(s, key, n) == 0) {
+            if (s[n] == '=') return s + n + 1;
+            if (s[n] == 0 || s[n] == ' ') return s + n;
+        }
+        while (*s && *s != ' ') s++;
+    }
+    return NULL;
+}
+uint32_t mb_mem_upper_kb(void){ return g_mem_upper; }
+
+uintptr_t mb_reserved_end(void){
+    return (g_reserved_end + 0xFFF) & ~(uintptr_t)0xFFF;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file stdio_file.c
+ * @brief Buffers de stdio a medida para ficheros y lectura directa en fread grandes
+ *
+ * Se enlaza con -Wl,--wrap=fopen,--wrap=fread (ver Makefile.in):
+ *  - fopen: si el fd es un fichero regular se instala un buffer del tamaño
+ *    de st_blksize (cluster de FatFs, al menos STDIO_FILE_BUF_MIN) en lugar
+ *    del BUFSIZ de 1 KiB de newlib.
+ *  - fread: una petición >= que el buffer se vacía del buffer y el resto va
+ *    directamente a la memoria del llamador, sin pasar por el buffer.
+ * Todas las llamadas a fread se contabilizan en iostat_stdio; "hits" son
+ * las que se sirven enteras desde el buffer.
+ * fwrite no necesita envoltorio: __sfvwrite_r ya escribe directo cuando el
+ * bloque es mayor que el buffer y éste está vacío.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <reent.h>
+
+#include <kernel/iostat.h>
+
+#define STDIO_FILE_BUF_MIN 4096
+
+FILE*  __real_fopen(const char* path, const char* mode);
+size_t __real_fread(void* buf, size_t size, size_t n, FILE* fp);
+
+FILE* __wrap_fopen(const char* path, const char* mode){
+    FILE* fp = __real_fopen(path, mode);
+    if (!fp) return NULL;
+
+    struct stat st;
+    if (fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode) &&
+        st.st_blksize >= STDIO_FILE_BUF_MIN)
+        setvbuf(fp, NULL, _IOFBF, (size_t)st.st_blksize);   // newlib lo reserva y lo libera en fclose
+    return fp;
+}
+
+static size_t fread_direct(void* buf, size_t size, size_t n, FILE* fp){
+    size_t total = size * n;
+    // Sólo flujos de lectura con buffer grande propio, sin ungetc pendiente
+    if (size == 0 || total / size != n || fp->_bf._size < STDIO_FILE_BUF_MIN ||
+        total < (size_t)fp->_bf._size || !(fp->_flags & (__SRD | __SRW)) ||
+        (fp->_flags & __SWR) || fp->_ub._base != NULL)
+        return __real_fread(buf, size, n, fp);
+
+    flockfile(fp);
+    uint8_t* dst = (uint8_t*)buf;
+    size_t done = 0;
+
+    // 1) lo que ya estuviera en el buffer
+    if (fp->_r > 0) {
+        size_t k = (size_t)fp->_r < total ? (size_t)fp->_r : total;
+        memcpy(dst, fp->_p, k);
+        fp->_p += k;
+        fp->_r -= (int)k;
+        done = k;
+    }
+    // 2) el resto directo a la memoria del llamador (fp->_read mantiene _offset)
+    if (done < total) {
+        // El buffer ya no está justo antes de _offset: vacío, para que un
+        // fseek hacia atrás (__SOPT) no lo tome por la ventana actual
+        fp->_p = fp->_bf._base;
+        fp->_r = 0;
+    }
+    while (done < total) {
+        _READ_WRITE_RETURN_TYPE r = fp->_read(_REENT, fp->_cookie, (char*)dst + done, total - done);
+        if (r <= 0) { fp->_flags |= (r == 0) ? __SEOF : __SERR; break; }
+        done += (size_t)r;
+    }
+    funlockfile(fp);
+    return done / size;
+}
+
+size_t __wrap_fread(void* buf, size_t size, size_t n, FILE* fp){
+    uint64_t t0 = rdtsc();
+    size_t total = size * n;
+    if (total && fp->_r >= 0 && (size_t)fp->_r >= total) iostat_stdio.hits++;
+    size_t r = fread_direct(buf, size, n, fp);
+    iostat_read(&iostat_stdio, r * size, t0);
+    return r;
+}
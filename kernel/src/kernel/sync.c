@@ -0,0 +1,206 @@
+/**
+ * @file sync.c
+ * @brief Mutex, semáforos y variables de condición sobre las waitq_t de thread.c
+ *
+ * Los campos de cada mutex van bajo un spinlock, así que también los toman
+ * los AP (las tareas de kernel/task.h que llaman a malloc o printf). Un AP
+ * no tiene hilo: su dueño es su cpu_t y espera girando. Sólo los hilos del
+ * BSP se bloquean en 'waiters', y sólo cuando el dueño es otro hilo del BSP,
+ * que es quien los despertará al soltar; si el dueño es un AP, giran.
+ */
+#include <kernel/sync.h>
+#include <kernel/system.h>
+#include <kernel/console.h>
+#include <arch/x86/smp.h>
+#include <string.h>
+
+#define MUTEX_TAKEN      1
+#define MUTEX_BUSY_BSP   0              /* lo tiene un hilo del BSP: bloquearse */
+#define MUTEX_BUSY_AP   (-1)            /* lo tiene un AP: girar */
+
+static inline int on_ap(void){
+    return smp_cpu_count() > 1 && smp_cpu_id() != 0;
+}
+
+// Semáforos y variables de condición sólo esperan en waitq_t: desde un AP
+// se avisa y la llamada no hace nada, en vez de bloquear la CPU
+static int ap_refused(const char* what){
+    if (!on_ap()) return 0;
+    static const char msg[] = "\nsync: llamada desde un AP ignorada: ";
+    console_write(msg, sizeof(msg) - 1);    // printf tomaría un cerrojo de newlib
+    console_write(what, strlen(what));
+    console_write("\n", 1);
+    return 1;
+}
+
+static inline void spin_lock(volatile uint8_t* l){
+    while (__atomic_exchange_n(l, 1, __ATOMIC_ACQUIRE))
+        while (__atomic_load_n(l, __ATOMIC_RELAXED)) cpu_relax();
+}
+
+static inline void spin_unlock(volatile uint8_t* l){
+    __atomic_store_n(l, 0, __ATOMIC_RELEASE);
+}
+
+// ---------- mutex ----------
+
+void mutex_init(mutex_t* m, int recursive){
+    *m = (mutex_t)MUTEX_INIT;
+    m->recursive = recursive ? 1 : 0;
+}
+
+// Con IF=0; 'self' es el hilo del BSP o el cpu_t del AP
+static int mutex_take(mutex_t* m, const void* self){
+    int r = MUTEX_TAKEN;
+    spin_lock(&m->lock);
+    if (m->owner == self && m->recursive) {
+        m->depth++;
+    } else if (m->owner) {
+        r = m->owner_ap ? MUTEX_BUSY_AP : MUTEX_BUSY_BSP;
+    } else {
+        m->owner    = self;
+        m->owner_ap = on_ap();
+        m->depth    = 1;
+    }
+    spin_unlock(&m->lock);
+    return r;
+}
+
+// Con IF=0; 1 si la última toma se ha soltado
+static int mutex_put(mutex_t* m, const void* self){
+    int freed = 0;
+    spin_lock(&m->lock);
+    if (m->owner == self && --m->depth == 0) {
+        m->owner = NULL;
+        freed = 1;
+    }
+    spin_unlock(&m->lock);
+    return freed;
+}
+
+// Con IF=0, en el BSP: despierta a un aspirante cuando la última toma se suelta
+static void mutex_release(mutex_t* m){
+    if (mutex_put(m, thread_current())) waitq_wake_one(&m->waiters);
+}
+
+void mutex_lock(mutex_t* m){
+    if (on_ap()) {
+        unsigned long flags = irq_save();
+        while (mutex_take(m, this_cpu()) != MUTEX_TAKEN) cpu_relax();
+        irq_restore(flags);
+        return;
+    }
+    thread_t* self = thread_current();
+    if (!self) return;
+    unsigned long flags = irq_save();
+    int r;
+    while ((r = mutex_take(m, self)) != MUTEX_TAKEN) {
+        if (r == MUTEX_BUSY_BSP) {
+            waitq_wait(&m->waiters);        // el dueño no puede correr: IF=0 en el BSP
+        } else {
+            irq_restore(flags);             // un AP lo suelta en poco tiempo
+            cpu_relax();
+            flags = irq_save();
+        }
+    }
+    irq_restore(flags);
+}
+
+int mutex_trylock(mutex_t* m){
+    const void* self = on_ap() ? (const void*)this_cpu() : (const void*)thread_current();
+    if (!self) return 1;
+    unsigned long flags = irq_save();
+    int ok = mutex_take(m, self) == MUTEX_TAKEN;
+    irq_restore(flags);
+    return ok;
+}
+
+void mutex_unlock(mutex_t* m){
+    if (on_ap()) {
+        unsigned long flags = irq_save();
+        mutex_put(m, this_cpu());           // los hilos del BSP no esperan a un AP en la cola
+        irq_restore(flags);
+        return;
+    }
+    if (!thread_current()) return;
+    unsigned long flags = irq_save();
+    mutex_release(m);
+    sched_preempt_check(flags);
+    irq_restore(flags);
+}
+
+// ---------- semáforos ----------
+
+void semaphore_init(semaphore_t* s, int count){
+    *s = (semaphore_t)SEMAPHORE_INIT(count);
+}
+
+void semaphore_wait(semaphore_t* s){
+    if (ap_refused("semaphore_wait")) return;
+    unsigned long flags = irq_save();
+    if (thread_current()) {
+        while (s->count == 0) waitq_wait(&s->waiters);
+    } else {
+        while (s->count == 0) {             // sin hilos sólo puede subirlo una ISR
+            enable_interrupts();
+            halt_cpu();
+            disable_interrupts();
+        }
+    }
+    s->count--;
+    irq_restore(flags);
+}
+
+int semaphore_trywait(semaphore_t* s){
+    if (ap_refused("semaphore_trywait")) return 0;
+    unsigned long flags = irq_save();
+    int ok = s->count > 0;
+    if (ok) s->count--;
+    irq_restore(flags);
+    return ok;
+}
+
+void semaphore_post(semaphore_t* s){
+    if (ap_refused("semaphore_post")) return;
+    unsigned long flags = irq_save();
+    s->count++;
+    if (thread_current()) {
+        waitq_wake_one(&s->waiters);
+        sched_preempt_check(flags);
+    }
+    irq_restore(flags);
+}
+
+// ---------- variables de condición ----------
+
+void condvar_init(condvar_t* c){
+    *c = (condvar_t)CONDVAR_INIT;
+}
+
+void condvar_wait(condvar_t* c, mutex_t* m){
+    if (ap_refused("condvar_wait")) return;
+    if (!thread_current()) return;
+    unsigned long flags = irq_save();
+    mutex_release(m);                       // soltar y encolarse sin perder un aviso
+    waitq_wait(&c->waiters);
+    irq_restore(flags);
+    mutex_lock(m);
+}
+
+void condvar_signal(condvar_t* c){
+    if (ap_refused("condvar_signal")) return;
+    if (!thread_current()) return;
+    unsigned long flags = irq_save();
+    waitq_wake_one(&c->waiters);
+    sched_preempt_check(flags);
+    irq_restore(flags);
+}
+
+void condvar_broadcast(condvar_t* c){
+    if (ap_refused("condvar_broadcast")) return;
+    if (!thread_current()) return;
+    unsigned long flags = irq_save();
+    waitq_wake_all(&c->waiters);
+    sched_preempt_check(flags);
+    irq_restore(flags);
+}
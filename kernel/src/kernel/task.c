@@ -0,0 +1,239 @@
+/**
+ * @file task.c
+ * @brief Deques de Chase-Lev por CPU, robo aleatorio y aparcado de los AP en hlt
+ *
+ * Las barreras siguen la versión C11 de Lê, Pop, Cohen y Zappa Nardelli
+ * ("Correct and Efficient Work-Stealing for Weak Memory Models"); en x86
+ * sólo la de take/steal genera una instrucción (mfence).
+ */
+#include <kernel/task.h>
+#include <kernel/system.h>
+#include <kernel/thread.h>
+#include <arch/x86/lapic.h>
+#include <arch/x86/smp.h>
+#include <arch/x86/tsc.h>
+#include <stddef.h>
+
+typedef struct {
+    int32_t  top;                           /* lo avanzan los ladrones (CAS) */
+    uint8_t  pad[60];                       /* top y bottom en líneas distintas */
+    int32_t  bottom;                        /* sólo lo escribe el dueño */
+    uint32_t rng;                           /* xorshift para elegir víctima */
+    task_t*  buf[TASK_DEQUE_SIZE];
+} __attribute__((aligned(64))) task_deque_t;
+
+// Vueltas de task_wait sin trabajo antes de ceder el BSP a otros hilos
+#define TASK_WAIT_SPINS 4096
+
+static task_deque_t tq[SMP_MAX_CPUS];
+static int          tq_ncpus = 1;
+static uint32_t     tq_parked;              /* bit i: la CPU i está en hlt */
+
+// ---------- deque ----------
+
+// Dueño: apila por abajo; -1 si está llena
+static int dq_push(task_deque_t* d, task_t* t){
+    int32_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED);
+    int32_t top = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    if (b - top >= TASK_DEQUE_SIZE) return -1;
+    __atomic_store_n(&d->buf[b & (TASK_DEQUE_SIZE - 1)], t, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+// Dueño: desapila por abajo; compite con los ladrones sólo por el último elemento
+static task_t* dq_take(task_deque_t* d){
+    int32_t b = __atomic_load_n(&d->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&d->bottom, b, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int32_t top = __atomic_load_n(&d->top, __ATOMIC_RELAXED);
+
+    if (top > b) {                          // vacía
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    task_t* t = __atomic_load_n(&d->buf[b & (TASK_DEQUE_SIZE - 1)], __ATOMIC_RELAXED);
+    if (top == b) {
+        if (!__atomic_compare_exchange_n(&d->top, &top, top + 1, 0,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            t = NULL;                       // se la ha llevado un ladrón
+        __atomic_store_n(&d->bottom, b + 1, __ATOMIC_RELAXED);
+    }
+    return t;
+}
+
+// Ladrón: toma por arriba; NULL si está vacía o pierde la carrera
+static task_t* dq_steal(task_deque_t* d){
+    int32_t top = __atomic_load_n(&d->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    int32_t b = __atomic_load_n(&d->bottom, __ATOMIC_ACQUIRE);
+    if (top >= b) return NULL;
+
+    task_t* t = __atomic_load_n(&d->buf[top & (TASK_DEQUE_SIZE - 1)], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&d->top, &top, top + 1, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        return NULL;
+    return t;
+}
+
+static int dq_empty(task_deque_t* d){
+    return __atomic_load_n(&d->bottom, __ATOMIC_SEQ_CST) -
+           __atomic_load_n(&d->top, __ATOMIC_SEQ_CST) <= 0;
+}
+
+// ---------- planificación ----------
+
+// Todos los hilos del BSP comparten la deque 0 como dueños: push y take van
+// con IF=0 para que el tic del PIT no cambie de hilo a mitad de una
+static int task_push(int self, task_t* t){
+    unsigned long flags = irq_save();
+    int r = dq_push(&tq[self], t);
+    irq_restore(flags);
+    return r;
+}
+
+static task_t* task_take(int self){
+    unsigned long flags = irq_save();
+    task_t* t = dq_take(&tq[self]);
+    irq_restore(flags);
+    return t;
+}
+
+static int task_self(void){
+    return tq_ncpus > 1 ? (int)smp_cpu_id() : 0;
+}
+
+static void task_run(task_t* t){
+    t->fn(t->arg);
+    __atomic_store_n(&t->done, 1, __ATOMIC_RELEASE);
+}
+
+// Una tarea propia o, si no hay, una robada a una CPU al azar
+static task_t* task_find(int self){
+    task_deque_t* d = &tq[self];
+    task_t* t = task_take(self);
+    if (t || tq_ncpus == 1) return t;
+
+    for (int i = 0; i < 2 * tq_ncpus; i++) {
+        d->rng ^= d->rng << 13; d->rng ^= d->rng >> 17; d->rng ^= d->rng << 5;
+        int victim = (int)(d->rng % (uint32_t)tq_ncpus);
+        if (victim != self && (t = dq_steal(&tq[victim]))) return t;
+    }
+    return NULL;
+}
+
+// Despierta a una CPU aparcada, si la hay
+static void task_wake_one(void){
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);    // el push antes de mirar tq_parked
+    uint32_t parked = __atomic_load_n(&tq_parked, __ATOMIC_RELAXED);
+    if (!parked) return;
+    int i = __builtin_ctz(parked);
+    uint32_t bit = 1u << i;
+    if (__atomic_fetch_and(&tq_parked, ~bit, __ATOMIC_SEQ_CST) & bit)
+        lapic_send_ipi(smp_cpu(i)->apic_id, IPI_WAKEUP_VEC);
+}
+
+// hlt hasta la próxima IPI; se vuelve a mirar con IF=0 para no perder un aviso
+static void task_park(int self){
+    uint32_t bit = 1u << self;
+    __atomic_fetch_or(&tq_parked, bit, __ATOMIC_SEQ_CST);
+    disable_interrupts();
+    for (int i = 0; i < tq_ncpus; i++) {
+        if (!dq_empty(&tq[i])) {
+            __atomic_fetch_and(&tq_parked, ~bit, __ATOMIC_SEQ_CST);
+            enable_interrupts();
+            return;
+        }
+    }
+    __asm__ __volatile__("sti; hlt" ::: "memory");
+    __atomic_fetch_and(&tq_parked, ~bit, __ATOMIC_SEQ_CST);
+    this_cpu()->wakeups++;
+}
+
+// Bucle de los AP (vía smp_call; no vuelve)
+static void task_worker(void* arg){
+    int self = (int)(uintptr_t)arg;
+    for (;;) {
+        task_t* t = NULL;
+        for (int spin = 0; spin < 64 && !(t = task_find(self)); spin++) cpu_relax();
+        if (t) task_run(t);
+        else   task_park(self);
+    }
+}
+
+int task_init(void){
+    int n = smp_cpu_count();
+    for (int i = 0; i < n; i++) tq[i].rng = 0x9E3779B9u * (uint32_t)(i + 1) ^ (uint32_t)rdtsc();
+
+    tq_ncpus = n;                           // antes de smp_call: los AP ya leen tq_ncpus
+    for (int i = 1; i < n; i++) smp_call(i, task_worker, (void*)(uintptr_t)i);
+    return tq_ncpus;
+}
+
+int task_workers(void){ return tq_ncpus; }
+
+void task_spawn(task_t* t, task_fn_t fn, void* arg){
+    t->fn   = fn;
+    t->arg  = arg;
+    t->done = 0;
+    if (tq_ncpus == 1 || task_push(task_self(), t) < 0) {
+        task_run(t);                        // sin AP o deque llena: en el sitio
+        return;
+    }
+    task_wake_one();
+}
+
+// En el BSP la tarea puede estar a medias en un hilo expropiado de menor
+// prioridad: tras un rato girando se le cede la CPU hasta el siguiente tic
+void task_wait(task_t* t){
+    int self = task_self();
+    int spins = 0;
+    while (!__atomic_load_n(&t->done, __ATOMIC_ACQUIRE)) {
+        task_t* other = task_find(self);
+        if (other) {
+            task_run(other);
+            spins = 0;
+        } else if (self == 0 && ++spins >= TASK_WAIT_SPINS) {
+            spins = 0;
+            thread_yield_any();
+        } else {
+            cpu_relax();
+        }
+    }
+}
+
+// ---------- parallel_for ----------
+
+typedef struct {
+    task_range_fn_t fn;
+    void*           ctx;
+    int             lo, hi, grain;
+} pf_range_t;
+
+// Deja la mitad alta para robo y baja por la mitad baja: profundidad log2(n/grain)
+static void pf_run(void* arg){
+    pf_range_t* r = arg;
+    if (r->hi - r->lo <= r->grain) {
+        r->fn(r->ctx, r->lo, r->hi);
+        return;
+    }
+    int mid = r->lo + (r->hi - r->lo) / 2;
+    pf_range_t upper = { r->fn, r->ctx, mid, r->hi, r->grain };
+    pf_range_t lower = { r->fn, r->ctx, r->lo, mid, r->grain };
+    task_t t;
+    task_spawn(&t, pf_run, &upper);
+    pf_run(&lower);
+    task_wait(&t);
+}
+
+void parallel_for(int begin, int end, int grain, task_range_fn_t fn, void* ctx){
+    if (end <= begin) return;
+    if (grain < 1) grain = 1;
+    if (tq_ncpus == 1) {
+        fn(ctx, begin, end);
+        return;
+    }
+    pf_range_t r = { fn, ctx, begin, end, grain };
+    pf_run(&r);
+}
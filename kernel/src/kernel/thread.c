@@ -0,0 +1,335 @@
+/**
+ * @file thread.c
+ * @brief Colas de listos por prioridad, dormidos ordenados por tic y cambio de contexto
+ *
+ * Todo cambio de hilo pasa por schedule() con IF=0. Un hilo expropiado por
+ * el PIT se queda dentro de su sched_tick(), con el marco de la IRQ en su
+ * pila, y al volver a elegirlo termina la ISR con su propio iret. Un hilo
+ * nuevo empieza en thread_entry(), que activa las interrupciones.
+ *
+ * FPU perezosa: g_fpu_owner es el hilo cuyo estado x87/SSE está en los
+ * registros. Al entrar cualquier otro se pone CR0.TS; si llega a usar la
+ * FPU, el #NM guarda la del dueño y carga la suya (o un estado limpio la
+ * primera vez). Los hilos que no tocan la FPU no cuestan ningún FXSAVE.
+ */
+#include <kernel/thread.h>
+#include <kernel/system.h>
+#include <drivers/pit.h>
+#include <arch/x86/fpu.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define THREAD_IDLE_STACK   (8 * 1024)
+
+void thread_switch(uint32_t* save_esp, uint32_t load_esp);     /* switch.S */
+
+static thread_t  g_main;
+static thread_t  g_idle;
+static uint8_t   g_idle_stack[THREAD_IDLE_STACK] __attribute__((aligned(16)));
+static thread_t* g_current;
+static waitq_t   g_ready[THREAD_PRIOS];
+static thread_t* g_sleepers;                /* ordenados por wake_tick */
+static int       g_need_resched;
+static int       g_nthreads;
+static uint32_t  g_next_id = 1;
+static thread_t* g_fpu_owner;               /* NULL: nadie tiene estado vivo en la FPU */
+static int       g_fpu_ts;                  /* espejo de CR0.TS para no reescribir CR0 */
+static thread_fpu_stats_t g_fpu_stats;
+
+// ---------- colas ----------
+
+static void wq_push(waitq_t* q, thread_t* t){
+    t->next = NULL;
+    if (q->tail) q->tail->next = t;
+    else         q->head = t;
+    q->tail = t;
+}
+
+static thread_t* wq_pop(waitq_t* q){
+    thread_t* t = q->head;
+    if (t) {
+        q->head = t->next;
+        if (!q->head) q->tail = NULL;
+        t->next = NULL;
+    }
+    return t;
+}
+
+static int ready_any(void){
+    for (int p = 0; p < THREAD_PRIOS; p++) if (g_ready[p].head) return 1;
+    return 0;
+}
+
+// El idle tiene prio THREAD_PRIOS: cualquier hilo listo le expropia
+static void make_ready(thread_t* t){
+    t->state = THREAD_READY;
+    wq_push(&g_ready[t->prio], t);
+    if (t->prio < g_current->prio) g_need_resched = 1;
+}
+
+static void sleepers_insert(thread_t* t){
+    thread_t** pp = &g_sleepers;
+    while (*pp && (int32_t)((*pp)->wake_tick - t->wake_tick) <= 0) pp = &(*pp)->next;
+    t->next = *pp;
+    *pp = t;
+}
+
+// ---------- FPU perezosa (IF=0) ----------
+
+// TS=0 sólo si 'next' ya es el dueño; en otro caso su primer uso dará #NM
+static void fpu_switch_to(thread_t* next){
+    if (next == g_fpu_owner) {
+        if (g_fpu_ts) { fpu_clear_ts(); g_fpu_ts = 0; }
+    } else if (!g_fpu_ts) {
+        fpu_set_ts();
+        g_fpu_ts = 1;
+    }
+}
+
+int thread_handle_nm(void){
+    if (!g_current || !(read_cr0() & CR0_TS)) return 0;
+    fpu_clear_ts();
+    g_fpu_ts = 0;
+    g_fpu_stats.traps++;
+
+    if (g_fpu_owner != g_current) {
+        if (g_fpu_owner) {
+            fpu_fxsave(g_fpu_owner->fpu);
+            g_fpu_owner->fpu_saved = 1;
+            g_fpu_stats.saves++;
+        }
+        if (g_current->fpu_saved) {
+            fpu_fxrstor(g_current->fpu);
+            g_fpu_stats.restores++;
+        } else {
+            fpu_reset();
+        }
+        g_fpu_owner = g_current;
+    }
+    return 1;
+}
+
+const thread_fpu_stats_t* thread_fpu_stats(void){ return &g_fpu_stats; }
+
+void thread_fpu_dump(void){
+    const thread_fpu_stats_t* s = &g_fpu_stats;
+    printf("fpu: %u cambios de hilo, %u #NM, %u FXSAVE (%u evitados), %u FXRSTOR\n",
+           (unsigned)s->switches, (unsigned)s->traps, (unsigned)s->saves,
+           (unsigned)(s->switches - s->saves), (unsigned)s->restores);
+}
+
+// ---------- planificación (IF=0) ----------
+
+// Pasa al primer hilo listo de mayor prioridad (o al idle). El actual ya
+// debe estar encolado, bloqueado, dormido o muerto.
+static void schedule(void){
+    thread_t* next = NULL;
+    for (int p = 0; p < THREAD_PRIOS && !next; p++) next = wq_pop(&g_ready[p]);
+    if (!next) next = &g_idle;
+
+    g_need_resched = 0;
+    next->state = THREAD_RUNNING;
+    next->slice = THREAD_SLICE_TICKS;
+    if (next == g_current) return;
+
+    thread_t* prev = g_current;
+    g_current = next;
+    next->switches++;
+    g_fpu_stats.switches++;
+    fpu_switch_to(next);
+    thread_switch(&prev->esp, next->esp);
+}
+
+// El actual vuelve al final de su cola y se elige otro
+static void reschedule(void){
+    if (g_current != &g_idle) {
+        g_current->state = THREAD_READY;
+        wq_push(&g_ready[g_current->prio], g_current);
+    }
+    schedule();
+}
+
+void sched_tick(void){
+    if (!g_current) return;
+
+    while (g_sleepers && (int32_t)(pit_ticks - g_sleepers->wake_tick) >= 0) {
+        thread_t* t = g_sleepers;
+        g_sleepers = t->next;
+        make_ready(t);
+    }
+
+    if (g_current->slice) g_current->slice--;
+    if (g_need_resched || (g_current->slice == 0 && ready_any())) reschedule();
+}
+
+void sched_preempt_check(unsigned long flags){
+    if (g_need_resched && (flags & 0x200)) reschedule();
+}
+
+// ---------- colas de espera ----------
+
+void waitq_wait(waitq_t* q){
+    g_current->state = THREAD_BLOCKED;
+    wq_push(q, g_current);
+    schedule();
+}
+
+int waitq_wake_one(waitq_t* q){
+    thread_t* t = wq_pop(q);
+    if (!t) return 0;
+    make_ready(t);
+    return 1;
+}
+
+int waitq_wake_all(waitq_t* q){
+    int n = 0;
+    while (waitq_wake_one(q)) n++;
+    return n;
+}
+
+// ---------- ciclo de vida ----------
+
+static void thread_entry(void){
+    enable_interrupts();
+    g_current->fn(g_current->arg);
+    thread_exit();
+}
+
+static void idle_loop(void* arg){
+    (void)arg;
+    for (;;) halt_cpu();
+}
+
+// Pila inicial: thread_switch saca edi, esi, ebx, ebp y "vuelve" a thread_entry
+static void thread_prepare(thread_t* t, uint8_t* stack, size_t size){
+    uint32_t* sp = (uint32_t*)(stack + size);
+    *--sp = 0;                              // retorno de thread_entry (no vuelve)
+    *--sp = (uint32_t)thread_entry;
+    for (int i = 0; i < 4; i++) *--sp = 0;
+    t->esp = (uint32_t)sp;
+}
+
+void thread_init(void){
+    if (g_current) return;
+
+    g_main.name  = "main";
+    g_main.prio  = THREAD_PRIO_DEFAULT;
+    g_main.state = THREAD_RUNNING;
+    g_main.slice = THREAD_SLICE_TICKS;
+
+    g_idle.id   = g_next_id++;
+    g_idle.name = "idle";
+    g_idle.prio = THREAD_PRIOS;
+    g_idle.fn   = idle_loop;
+    thread_prepare(&g_idle, g_idle_stack, sizeof(g_idle_stack));
+
+    g_nthreads  = 1;
+    g_current   = &g_main;
+    g_fpu_owner = &g_main;                  // kernel_main ya ha podido usar la FPU con TS=0
+}
+
+thread_t* thread_create(const char* name, thread_fn_t fn, void* arg, int prio, size_t stack_size){
+    if (!g_current) return NULL;
+    if (prio < 0 || prio >= THREAD_PRIOS) prio = THREAD_PRIO_DEFAULT;
+    if (!stack_size) stack_size = THREAD_STACK_DEFAULT;
+    stack_size = (stack_size + 15) & ~(size_t)15;
+
+    thread_t* t = memalign(16, sizeof(*t));     // fpu[] debe quedar alineada a 16
+    uint8_t*  stack = memalign(16, stack_size);
+    if (!t || !stack) {
+        free(t);
+        free(stack);
+        return NULL;
+    }
+    memset(t, 0, sizeof(*t));
+    t->name  = name;
+    t->prio  = (uint8_t)prio;
+    t->fn    = fn;
+    t->arg   = arg;
+    t->stack = stack;
+    thread_prepare(t, stack, stack_size);
+
+    unsigned long flags = irq_save();
+    t->id = g_next_id++;
+    g_nthreads++;
+    make_ready(t);
+    sched_preempt_check(flags);
+    irq_restore(flags);
+    return t;
+}
+
+void thread_exit(void){
+    disable_interrupts();
+    g_current->state = THREAD_DEAD;
+    g_nthreads--;
+    if (g_fpu_owner == g_current) g_fpu_owner = NULL;   // su estado ya no hace falta
+    waitq_wake_all(&g_current->joiners);
+    schedule();
+    for (;;) halt_cpu();                    // no se vuelve a elegir un hilo muerto
+}
+
+void thread_join(thread_t* t){
+    if (!t || t == g_current || !t->stack) return;
+    unsigned long flags = irq_save();
+    while (t->state != THREAD_DEAD) waitq_wait(&t->joiners);
+    irq_restore(flags);
+    free(t->stack);
+    free(t);
+}
+
+thread_t* thread_current(void){ return g_current; }
+
+int thread_count(void){ return g_current ? g_nthreads : 0; }
+
+int thread_yield(void){
+    if (!g_current) return 0;
+    unsigned long flags = irq_save();
+    thread_t* self = g_current;
+    uint32_t before = self->switches;
+    reschedule();
+    int other = self->switches != before;
+    irq_restore(flags);
+    return other;
+}
+
+void thread_sleep_ms(uint32_t ms){
+    uint32_t hz = pit_hz() ? pit_hz() : 100;
+    uint32_t ticks = (uint32_t)(((uint64_t)ms * hz + 999) / 1000);
+    if (ticks == 0) {
+        thread_yield();
+        return;
+    }
+
+    if (!g_current) {                       // sin planificador: hlt hasta el tic
+        uint32_t t0 = pit_ticks;
+        while (pit_ticks - t0 < ticks) halt_cpu();
+        return;
+    }
+
+    unsigned long flags = irq_save();
+    g_current->wake_tick = pit_ticks + ticks;
+    g_current->state = THREAD_SLEEPING;
+    sleepers_insert(g_current);
+    schedule();
+    irq_restore(flags);
+}
+
+int thread_yield_any(void){
+    unsigned long flags = irq_save();
+    if (!g_current || !ready_any()) {
+        irq_restore(flags);
+        return 0;
+    }
+    g_current->wake_tick = pit_ticks + 1;
+    g_current->state = THREAD_SLEEPING;
+    sleepers_insert(g_current);
+    schedule();
+    irq_restore(flags);
+    return 1;
+}
+
+void thread_idle_wait(void){
+    if (!thread_yield_any()) halt_cpu();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file tty.c
+ * @brief /dev/tty sobre las capas console (salida) y stdin (entrada)
+ *
+ * La disciplina de línea saca del teclado todo lo disponible de una vez
+ * (stdin_read) y emite el eco de cada tanda con un único console_write.
+ */
+#include <kernel/tty.h>
+#include <kernel/console.h>   // console_write()
+#include <kernel/stdin.h>     // stdin_read()
+#include <kernel/idle.h>      // kernel_idle()
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TTY_CHUNK 64     // bytes sacados del teclado por despertar
+
+// Disciplina de línea de /dev/tty (una sola consola)
+typedef struct {
+    tty_termios_t t;
+    char*  line;                // línea en edición o por entregar
+    size_t len;                 // bytes editados (modo canónico)
+    size_t have, pos;           // línea terminada: pendientes y siguiente a entregar
+    char   in[TTY_CHUNK];       // lo leído de stdin y aún no procesado
+    size_t in_pos, in_len;
+} tty_ldisc_t;
+
+static char g_line0[TTY_LINE_DEFAULT];
+static tty_ldisc_t g_tty = {
+    .t    = { TTY_ICANON | TTY_ECHO | TTY_ICRNL, TTY_LINE_DEFAULT },
+    .line = g_line0,
+};
+
+void tty_getattr(tty_termios_t* t){ *t = g_tty.t; }
+
+int tty_setattr(const tty_termios_t* t){
+    if (t->line_max < 2) { errno = EINVAL; return -1; }
+    if (t->line_max != g_tty.t.line_max) {
+        if (g_tty.len || g_tty.have) { errno = EBUSY; return -1; }
+        char* nl = (char*)malloc(t->line_max);
+        if (!nl) { errno = ENOMEM; return -1; }
+        if (g_tty.line != g_line0) free(g_tty.line);
+        g_tty.line = nl;
+    }
+    g_tty.t = *t;
+    return 0;
+}
+
+// Rellena 'in' desde stdin en bloque; bloquea (idle/hlt) hasta tener algo
+static void tty_fill(tty_ldisc_t* l){
+    while (l->in_pos == l->in_len) {
+        l->in_pos = 0;
+        l->in_len = stdin_read(l->in, sizeof(l->in));
+        if (l->in_len == 0) kernel_idle();
+    }
+}
+
+static ssize_t tty_deliver(tty_ldisc_t* l, void* buf, size_t count){
+    size_t n = l->have < count ? l->have : count;
+    memcpy(buf, l->line + l->pos, n);
+    l->pos  += n;
+    l->have -= n;
+    return (ssize_t)n;
+}
+
+// Edita con lo disponible en 'in'; el eco de la tanda sale en un solo console_write.
+// Devuelve 1 si se completó una línea.
+static int tty_edit(tty_ldisc_t* l){
+    char echo[TTY_CHUNK * 3];                   // "\b \b" por tecla como mucho
+    size_t e = 0;
+    int done = 0;
+
+    while (!done && l->in_pos < l->in_len) {
+        char c = l->in[l->in_pos++];
+        if (c == '\r' && (l->t.lflag & TTY_ICRNL)) c = '\n';
+
+        if (c == '\b' || (unsigned char)c == 0x7F) {
+            // no borra antes del inicio de la línea
+            if (l->len > 0) { l->len--; memcpy(echo + e, "\b \b", 3); e += 3; }
+        } else if (c == '\n') {
+            l->line[l->len++] = '\n';           // siempre queda sitio (ver abajo)
+            echo[e++] = '\n';
+            l->pos = 0; l->have = l->len; l->len = 0;
+            done = 1;
+        } else if (l->len + 1 < l->t.line_max) { // reserva sitio para el '\n'
+            l->line[l->len++] = c;
+            echo[e++] = c;
+        }
+    }
+    if (e && (l->t.lflag & TTY_ECHO)) console_write(echo, e);
+    return done;
+}
+
+static ssize_t tty_read(vfs_file_t* f, void* buf, size_t count){
+    (void)f;
+    tty_ldisc_t* l = &g_tty;
+    if (count == 0) return 0;
+    if (l->have > 0) return tty_deliver(l, buf, count);   // resto de una línea previa
+
+    if (!(l->t.lflag & TTY_ICANON)) {
+        // RAW: devolver lo disponible, primero lo ya leído de stdin
+        tty_fill(l);
+        size_t n = l->in_len - l->in_pos;
+        if (n > count) n = count;
+        memcpy(buf, l->in + l->in_pos, n);
+        l->in_pos += n;
+        if (l->t.lflag & TTY_ECHO) console_write((const char*)buf, n);
+        return (ssize_t)n;
+    }
+
+    // CANÓNICO: bloquea hasta completar una línea
+    for (;;) {
+        tty_fill(l);
+        if (tty_edit(l)) return tty_deliver(l, buf, count);
+    }
+}
+
+static ssize_t tty_write(vfs_file_t* f, const void* buf, size_t count){
+    (void)f;
+    console_write((const char*)buf, count);
+    return (ssize_t)count;
+}
+
+static int tty_fstat(vfs_file_t* f, struct stat* st){
+    (void)f;
+    memset(st, 0, sizeof(*st));
+    st->st_mode  = S_IFCHR;
+    st->st_nlink = 1;
+    return 0;
+}
+
+static const vfs_file_ops_t TTY_OPS = {
+    .read  = tty_read,
+    .write = tty_write,
+    .fstat = tty_fstat,
+};
+
+int tty_open(vfs_file_t* f, int oflag){
+    (void)oflag;
+    f->ops = &TTY_OPS;
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file vfs.c
+ * @brief Puntos de montaje, resolución de rutas y tabla de fds
+ */
+#include <kernel/vfs.h>
+#include <kernel/initrd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char*         prefix;
+    size_t              len;
+    const vfs_fs_ops_t* ops;
+    void*               ctx;
+} vfs_mount_t;
+
+static vfs_mount_t g_mounts[VFS_MAX_MOUNTS];
+static int         g_nmounts = 0;
+
+// Tabla creciente de punteros (los ficheros no se mueven al ampliarla) y
+// pila de índices libres: alta y baja en O(1).
+static vfs_file_t** g_fd = NULL;
+static int*         g_fd_free = NULL;   // índices libres (pila)
+static int          g_fd_cap = 0;
+static int          g_fd_nfree = 0;
+
+int vfs_mount(const char* prefix, const vfs_fs_ops_t* ops, void* ctx){
+    if (g_nmounts >= VFS_MAX_MOUNTS) { errno = ENOMEM; return -1; }
+    g_mounts[g_nmounts++] = (vfs_mount_t){ prefix, strlen(prefix), ops, ctx };
+    return 0;
+}
+
+// Montaje de prefijo más largo; "/dev" casa con "/dev" y "/dev/x", no con "/devx"
+static const vfs_mount_t* resolve(const char* path, const char** sub){
+    const vfs_mount_t* best = NULL;
+    for (int i = 0; i < g_nmounts; i++) {
+        const vfs_mount_t* m = &g_mounts[i];
+        if (best && m->len <= best->len) continue;
+        if (strncmp(path, m->prefix, m->len) != 0) continue;
+        if (m->len && path[m->len] != 0 && path[m->len] != '/') continue;
+        best = m;
+    }
+    if (best) {
+        const char* s = path + best->len;
+        if (best->len && *s == '/') s++;
+        *sub = s;
+    }
+    return best;
+}
+
+static int fd_grow(void){
+    int ncap = g_fd_cap ? g_fd_cap * 2 : VFS_FD_INIT_CAP;
+    if (ncap > VFS_FD_MAX) ncap = VFS_FD_MAX;
+    if (ncap <= g_fd_cap) return -1;
+    vfs_file_t** t = (vfs_file_t**)realloc(g_fd, ncap * sizeof(*t));
+    if (!t) return -1;
+    g_fd = t;
+    int* fl = (int*)realloc(g_fd_free, ncap * sizeof(*fl));
+    if (!fl) return -1;
+    g_fd_free = fl;
+    // Se apilan al revés para que salgan primero los índices bajos
+    for (int i = ncap - 1; i >= g_fd_cap; i--) { g_fd[i] = NULL; g_fd_free[g_fd_nfree++] = i; }
+    g_fd_cap = ncap;
+    return 0;
+}
+
+vfs_file_t* vfs_fd(int fd){
+    return (unsigned)fd < (unsigned)g_fd_cap ? g_fd[fd] : NULL;
+}
+
+int vfs_open(const char* path, int oflag){
+    const char* sub;
+    const vfs_mount_t* m = resolve(path, &sub);
+    if (!m) { errno = ENOENT; return -1; }
+    if (g_fd_nfree == 0 && fd_grow() < 0) { errno = EMFILE; return -1; }
+
+    vfs_file_t* f = (vfs_file_t*)calloc(1, sizeof(*f));
+    if (!f) { errno = ENOMEM; return -1; }
+    f->oflag = oflag;
+    if (m->ops->open(m->ctx, sub, oflag, f) < 0) { free(f); return -1; }
+    f->io = iostat_open(path);
+
+    int fd = g_fd_free[--g_fd_nfree];
+    g_fd[fd] = f;
+    return fd;
+}
+
+int vfs_close(int fd){
+    vfs_file_t* f = vfs_fd(fd);
+    if (!f) { errno = EBADF; return -1; }
+    g_fd[fd] = NULL;
+    g_fd_free[g_fd_nfree++] = fd;
+    int r = f->ops->close ? f->ops->close(f) : 0;
+    free(f);
+    return r;
+}
+
+void vfs_sync(void){
+    for (int fd = 0; fd < g_fd_cap; fd++)
+        if (g_fd[fd] && g_fd[fd]->ops->fsync) g_fd[fd]->ops->fsync(g_fd[fd]);
+}
+
+int vfs_unlink(const char* path){
+    const char* sub;
+    const vfs_mount_t* m = resolve(path, &sub);
+    if (!m) { errno = ENOENT; return -1; }
+    if (!m->ops->unlink) { errno = EROFS; return -1; }
+    return m->ops->unlink(m->ctx, sub);
+}
+
+int vfs_rename(const char* oldp, const char* newp){
+    const char *so, *sn;
+    const vfs_mount_t* m  = resolve(oldp, &so);
+    const vfs_mount_t* mn = resolve(newp, &sn);
+    if (!m || !mn) { errno = ENOENT; return -1; }
+    if (m != mn) { errno = EXDEV; return -1; }
+    if (!m->ops->rename) { errno = EROFS; return -1; }
+    return m->ops->rename(m->ctx, so, sn);
+}
+
+int vfs_mkdir(const char* path, mode_t mode){
+    const char* sub;
+    const vfs_mount_t* m = resolve(path, &sub);
+    if (!m) { errno = ENOENT; return -1; }
+    if (!m->ops->mkdir) { errno = EROFS; return -1; }
+    return m->ops->mkdir(m->ctx, sub, mode);
+}
+
+void vfs_init(void){
+    static const char initrd_mnt[] = INITRD_PREFIX;
+    static char initrd_prefix[sizeof(initrd_mnt)];
+    memcpy(initrd_prefix, initrd_mnt, sizeof(initrd_mnt) - 2);  // sin la barra final
+
+    vfs_mount("", &VFS_FATFS, NULL);
+    vfs_mount(initrd_prefix, &VFS_INITRD, NULL);
+    vfs_mount("/dev", &VFS_NODES, (void*)VFS_DEV_NODES);
+    vfs_mount("/sys", &VFS_NODES, (void*)VFS_SYS_NODES);
+
+    // stdin, stdout, stderr
+    vfs_open("/dev/tty", O_RDONLY);
+    vfs_open("/dev/tty", O_WRONLY);
+    vfs_open("/dev/tty", O_WRONLY);
+}
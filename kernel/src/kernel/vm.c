@@ -0,0 +1,202 @@
+/**
+ * @file vm.c
+ * @brief Mapeos de ficheros FatFs bajo demanda (PROT_READ, MAP_PRIVATE)
+ *
+ * Cada mapeo reserva un rango de la ventana virtual y guarda su propia
+ * tabla página → marco. Los marcos salen de un pool acotado; cuando se
+ * agota se expulsa una página con el algoritmo del reloj (bit Accessed de
+ * la PTE). Todas las páginas son limpias (sólo lectura), así que expulsar
+ * es desmapear y reutilizar el marco sin escribir nada a disco.
+ *
+ * El #PF no llama a malloc ni toma ningún cerrojo: los marcos se reservan
+ * en vm_map_file() y la página se lee con FatFs y el disco RAM. Sólo el BSP
+ * usa los mapeos (ver mman.h), así que basta con el invlpg local al
+ * expulsar; un fallo en un AP no se atiende.
+ */
+#include <kernel/vm.h>
+#include <arch/x86/paging.h>
+#include <arch/x86/smp.h>
+#include <errno.h>
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint8_t  used;
+    uint32_t va;            /* base virtual (alineada a página) */
+    uint32_t npages;
+    uint32_t off;           /* offset en el fichero de la página 0 */
+    FIL      fil;           /* copia privada: posición independiente del fd */
+    int16_t* frame_of;      /* tabla del mapeo: marco por página, -1 = no residente */
+} vm_mapping_t;
+
+typedef struct {
+    void*    mem;           /* 4 KiB alineados, reservados en el primer uso */
+    int16_t  map;           /* mapeo propietario, -1 = libre */
+    uint32_t page;
+} vm_frame_t;
+
+static vm_mapping_t g_maps[VM_MAX_MAPPINGS];
+static vm_frame_t   g_frames[VM_MAX_FRAMES];
+static int          g_frames_init = 0;
+static uint32_t     g_clock = 0;
+static vm_stats_t   g_stats;
+
+static void frames_init(void){
+    if (g_frames_init) return;
+    for (int i = 0; i < VM_MAX_FRAMES; i++) { g_frames[i].mem = NULL; g_frames[i].map = -1; }
+    g_frames_init = 1;
+}
+
+// Rango libre en la ventana (first-fit sobre los mapeos activos)
+static uint32_t find_va(uint32_t npages){
+    uint32_t size = npages * PAGE_SIZE;
+    uint32_t va = VM_WINDOW_BASE;
+    for (;;) {
+        if (va + size < va || va + size > VM_WINDOW_END) return 0;
+        int clash = 0;
+        for (int i = 0; i < VM_MAX_MAPPINGS; i++) {
+            vm_mapping_t* m = &g_maps[i];
+            if (!m->used) continue;
+            uint32_t end = m->va + m->npages * PAGE_SIZE;
+            if (va < end && m->va < va + size) { va = end; clash = 1; break; }
+        }
+        if (!clash) return va;
+    }
+}
+
+// Completa el pool hasta 'want' marcos con memoria; devuelve cuántos tiene
+static uint32_t frames_reserve(uint32_t want){
+    uint32_t have = 0;
+    for (int i = 0; i < VM_MAX_FRAMES; i++) if (g_frames[i].mem) have++;
+    for (int i = 0; i < VM_MAX_FRAMES && have < want; i++) {
+        if (g_frames[i].mem) continue;
+        g_frames[i].mem = memalign(PAGE_SIZE, PAGE_SIZE);
+        if (!g_frames[i].mem) break;
+        have++;
+    }
+    return have;
+}
+
+void* vm_map_file(const FIL* src, uint32_t off, uint32_t len){
+    if (!paging_enabled() || len == 0 || (off & (PAGE_SIZE - 1))) { errno = EINVAL; return NULL; }
+    frames_init();
+
+    int slot = -1;
+    for (int i = 0; i < VM_MAX_MAPPINGS; i++) if (!g_maps[i].used) { slot = i; break; }
+    if (slot < 0) { errno = ENOMEM; return NULL; }
+
+    uint32_t npages = (len + PAGE_SIZE - 1) / PAGE_SIZE;
+    uint32_t va = find_va(npages);
+    if (!va) { errno = ENOMEM; return NULL; }
+
+    // Las tablas de páginas se crean aquí y no en el #PF
+    for (uint32_t a = va & ~0x3FFFFFu; a < va + npages * PAGE_SIZE; a += 0x400000u)
+        if (paging_prepare(a) < 0) { errno = ENOMEM; return NULL; }
+
+    // Los marcos, también: el #PF no puede llamar a malloc. Con menos de
+    // npages residentes el reloj expulsa; sin ninguno no hay mapeo posible.
+    if (frames_reserve(npages < VM_MAX_FRAMES ? npages : VM_MAX_FRAMES) == 0) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    int16_t* tbl = (int16_t*)malloc(npages * sizeof(int16_t));
+    if (!tbl) { errno = ENOMEM; return NULL; }
+    for (uint32_t p = 0; p < npages; p++) tbl[p] = -1;
+
+    vm_mapping_t* m = &g_maps[slot];
+    m->va       = va;
+    m->npages   = npages;
+    m->off      = off;
+    m->fil      = *src;
+    m->fil.flag = FA_READ;          // la copia nunca escribe ni marca sucio
+    m->frame_of = tbl;
+    m->used     = 1;
+    g_stats.mappings++;
+    return (void*)va;
+}
+
+static void drop_page(vm_mapping_t* m, uint32_t page){
+    int16_t f = m->frame_of[page];
+    if (f < 0) return;
+    paging_unmap(m->va + page * PAGE_SIZE);
+    m->frame_of[page] = -1;
+    g_frames[f].map = -1;
+    g_stats.resident--;
+}
+
+int vm_unmap(void* addr){
+    for (int i = 0; i < VM_MAX_MAPPINGS; i++) {
+        vm_mapping_t* m = &g_maps[i];
+        if (!m->used || m->va != (uint32_t)addr) continue;
+        for (uint32_t p = 0; p < m->npages; p++) drop_page(m, p);
+        free(m->frame_of);
+        memset(m, 0, sizeof(*m));
+        g_stats.mappings--;
+        return 0;
+    }
+    errno = EINVAL;
+    return -1;
+}
+
+// Marco libre, o víctima del reloj entre las páginas residentes
+static int take_frame(void){
+    for (uint32_t scanned = 0; scanned < 2u * VM_MAX_FRAMES; scanned++) {
+        uint32_t i = g_clock;
+        g_clock = (g_clock + 1) % VM_MAX_FRAMES;
+        vm_frame_t* fr = &g_frames[i];
+
+        if (fr->map < 0) {
+            if (!fr->mem) continue;                 // fuera del pool reservado
+            return (int)i;
+        }
+        vm_mapping_t* m = &g_maps[fr->map];
+        uint32_t va = m->va + fr->page * PAGE_SIZE;
+        volatile uint32_t* pte = paging_pte(va);
+        if (pte && (*pte & PTE_ACCESSED)) {         // segunda oportunidad
+            *pte &= ~PTE_ACCESSED;
+            invlpg(va);
+            continue;
+        }
+        drop_page(m, fr->page);                     // limpia: no hay write-back
+        g_stats.evictions++;
+        return (int)i;
+    }
+    return -1;
+}
+
+int vm_handle_fault(uint32_t va, uint32_t err){
+    if (err & PF_ERR_PRESENT) return 0;             // escritura sobre R/O u otra violación
+    if (va < VM_WINDOW_BASE || va >= VM_WINDOW_END) return 0;
+    if (smp_cpu_count() > 1 && smp_cpu_id() != 0) return 0;   // sólo el BSP (ver mman.h)
+
+    for (int i = 0; i < VM_MAX_MAPPINGS; i++) {
+        vm_mapping_t* m = &g_maps[i];
+        if (!m->used || va < m->va || va >= m->va + m->npages * PAGE_SIZE) continue;
+
+        uint32_t page = (va - m->va) / PAGE_SIZE;
+        if (m->frame_of[page] >= 0) return 1;       // ya residente (TLB obsoleta)
+
+        int f = take_frame();
+        if (f < 0) return 0;
+        uint8_t* mem = (uint8_t*)g_frames[f].mem;
+
+        UINT br = 0;
+        FSIZE_t pos = (FSIZE_t)m->off + (FSIZE_t)page * PAGE_SIZE;
+        if (f_lseek(&m->fil, pos) != FR_OK || f_read(&m->fil, mem, PAGE_SIZE, &br) != FR_OK)
+            return 0;                               // error de disco: fallo fatal
+        if (br < PAGE_SIZE) memset(mem + br, 0, PAGE_SIZE - br);   // cola tras EOF
+
+        g_frames[f].map  = (int16_t)i;
+        g_frames[f].page = page;
+        m->frame_of[page] = (int16_t)f;
+        paging_map(m->va + page * PAGE_SIZE, (uint32_t)mem, 0);    // sólo lectura
+        g_stats.faults++;
+        g_stats.resident++;
+        return 1;
+    }
+    return 0;
+}
+
+void vm_get_stats(vm_stats_t* out){ *out = g_stats; }
@@ -6,3 +6,40 @@ BUILD_DIR="build-fatfs-i686"
 TARGET_TRIPLE="i686-elf"          # tripleta GNU para newlib (target)
 PREFIX_DIR="kernel"               # instalación relativa a la raíz del repo
 ZIG_TARGET="x86-freestanding"     # sólo si usamos Zig
+FATFS_SRC="fatfs/source"          # ff.c del submódulo
+CONF_DIR="kernel/include/fatfs"   # ff.h/ffconf.h/diskio.h que usa el kernel
+
+[ -f "$FATFS_SRC/ff.c" ] || FATFS_SRC="fatfs"
+
+# --- Selección condicional del toolchain ---
+if command -v zig >/dev/null 2>&1; then
+  echo "→ Usando Zig como toolchain para $TARGET_TRIPLE"
+  CC="zig cc -target $ZIG_TARGET"
+  AR="zig ar"
+elif command -v clang >/dev/null 2>&1; then
+  echo "→ Usando Clang/LLVM como toolchain para $TARGET_TRIPLE"
+  CC="clang --target=$TARGET_TRIPLE"
+  AR="llvm-ar"
+else
+  echo "→ Usando ${TARGET_TRIPLE}-gcc"
+  CC="${TARGET_TRIPLE}-gcc"
+  AR="${TARGET_TRIPLE}-ar"
+fi
+
+CFLAGS="-ffreestanding -fno-builtin -fno-stack-protector -fno-pic -O2 -m80387 \
+        -I$PREFIX_DIR/include/newlib -I$CONF_DIR"
+
+# --- Build ---
+# ff.c se copia al directorio de build para que "ffconf.h" salga de
+# kernel/include/fatfs y no del submódulo (la configuración cambia el
+# layout de FIL, p.ej. FF_USE_FASTSEEK añade cltbl).
+# diskio lo implementa el kernel (src/drivers/diskio.c), no se incluye.
+rm -rf "$BUILD_DIR"
+mkdir -p "$BUILD_DIR"
+cp "$FATFS_SRC/ff.c" "$BUILD_DIR/"
+$CC $CFLAGS -c "$BUILD_DIR/ff.c" -o "$BUILD_DIR/ff.o"
+
+rm -f "$PREFIX_DIR/lib/libfatfs.a"
+$AR rcs "$PREFIX_DIR/lib/libfatfs.a" "$BUILD_DIR/ff.o"
+
+echo "✔ FatFs instalada en: $PREFIX_DIR/lib/libfatfs.a"
@@ -22,6 +22,7 @@ if command -v hdiutil >/dev/null 2>&1; then
     cp ./limine/limine-bios.sys /Volumes/LIMINE/
     cp ./limine.conf                 /Volumes/LIMINE/
     cp ./kernel/kernel.elf          /Volumes/LIMINE/
+    if [ -f fat12.img ]; then cp ./fat12.img /Volumes/LIMINE/; fi
 
     sync
     sudo umount /Volumes/LIMINE || true
@@ -34,6 +35,7 @@ elif command -v parted >/dev/null 2>&1 && command -v mformat >/dev/null 2>&1 &&
     mcopy -o -i "$DISK_IMG"@@$PART_OFF limine/limine-bios.sys ::/
     mcopy -o -i "$DISK_IMG"@@$PART_OFF limine.conf ::/
     mcopy -o -i "$DISK_IMG"@@$PART_OFF kernel/kernel.elf ::/
+    if [ -f fat12.img ]; then mcopy -o -i "$DISK_IMG"@@$PART_OFF fat12.img ::/; fi
 
     ./limine/limine bios-install "$DISK_IMG"
 
@@ -0,0 +1,170 @@
+/**
+ * @file wadlz4.c
+ * @brief Herramienta de host: convierte un WAD en un WAD comprimido con LZ4
+ *
+ * Cada lump se comprime por separado para que el kernel pueda
+ * descomprimirlo bajo demanda (ver kernel/src/doom/w_file_kernel.c).
+ * El resultado sustituye al WAD original con el mismo nombre.
+ *
+ *   cc -O2 -Ikernel/include -o wadlz4 tools/wadlz4.c kernel/src/kernel/lz4.c
+ *   ./wadlz4 doom1.wad doom1.lz4.wad
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kernel/lz4.h>
+#include <kernel/wadlz4.h>
+
+#define MINMATCH     4
+#define LASTLITERALS 5      /* los últimos 5 bytes siempre son literales */
+#define MFLIMIT      12     /* un match no empieza en los últimos 12 bytes */
+#define HASH_BITS    16
+
+static uint32_t rd32(const uint8_t* p){
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint32_t hash4(uint32_t v){ return (v * 2654435761u) >> (32 - HASH_BITS); }
+
+static uint8_t* put_len(uint8_t* op, uint32_t len){
+    while (len >= 255) { *op++ = 255; len -= 255; }
+    *op++ = (uint8_t)len;
+    return op;
+}
+
+static uint8_t* put_seq(uint8_t* op, const uint8_t* lit, uint32_t nlit, uint32_t off, uint32_t mlen){
+    uint8_t* token = op++;
+    *token = (uint8_t)((nlit >= 15 ? 15 : nlit) << 4);
+    if (nlit >= 15) op = put_len(op, nlit - 15);
+    memcpy(op, lit, nlit);
+    op += nlit;
+    if (mlen) {
+        *op++ = (uint8_t)off;
+        *op++ = (uint8_t)(off >> 8);
+        mlen -= MINMATCH;
+        *token |= (uint8_t)(mlen >= 15 ? 15 : mlen);
+        if (mlen >= 15) op = put_len(op, mlen - 15);
+    }
+    return op;
+}
+
+/* Compresor voraz con tabla hash de 4 bytes. dst: n + n/255 + 16 bytes */
+static uint32_t lz4_compress(const uint8_t* src, uint32_t n, uint8_t* dst){
+    static uint32_t table[1u << HASH_BITS];     /* posición + 1, 0 = vacío */
+    memset(table, 0, sizeof(table));
+    uint8_t* op = dst;
+    uint32_t ip = 0, anchor = 0;
+
+    if (n > MFLIMIT) {
+        uint32_t mflimit = n - MFLIMIT;
+        uint32_t matchlimit = n - LASTLITERALS;
+        while (ip < mflimit) {
+            uint32_t v = rd32(src + ip);
+            uint32_t h = hash4(v);
+            uint32_t ref = table[h];
+            table[h] = ip + 1;
+            if (ref && ip - (ref - 1) <= 65535 && rd32(src + ref - 1) == v) {
+                ref--;
+                uint32_t len = MINMATCH;
+                while (ip + len < matchlimit && src[ref + len] == src[ip + len]) len++;
+                op = put_seq(op, src + anchor, ip - anchor, ip - ref, len);
+                ip += len;
+                anchor = ip;
+            } else {
+                ip++;
+            }
+        }
+    }
+    op = put_seq(op, src + anchor, n - anchor, 0, 0);
+    return (uint32_t)(op - dst);
+}
+
+typedef struct { uint32_t start, end; } span_t;
+
+static int span_cmp(const void* a, const void* b){
+    const span_t* x = a; const span_t* y = b;
+    return x->start < y->start ? -1 : x->start > y->start;
+}
+
+static void put32(uint8_t* p, uint32_t v){ p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+
+int main(int argc, char** argv){
+    if (argc != 3) { fprintf(stderr, "uso: %s entrada.wad salida.wad\n", argv[0]); return 2; }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (!in) { perror(argv[1]); return 1; }
+    fseek(in, 0, SEEK_END);
+    long lsize = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    if (lsize < 12) { fprintf(stderr, "%s: demasiado corto\n", argv[1]); return 1; }
+    uint32_t size = (uint32_t)lsize;
+    uint8_t* wad = malloc(size);
+    if (!wad || fread(wad, 1, size, in) != size) { fprintf(stderr, "error de lectura\n"); return 1; }
+    fclose(in);
+
+    if (memcmp(wad, "IWAD", 4) && memcmp(wad, "PWAD", 4)) { fprintf(stderr, "no es un WAD\n"); return 1; }
+    uint32_t numlumps = rd32(wad + 4), dirofs = rd32(wad + 8);
+    if (dirofs > size || numlumps > (size - dirofs) / 16) { fprintf(stderr, "directorio fuera del fichero\n"); return 1; }
+
+    /* Extensiones: cabecera, directorio y cada lump; las solapadas se funden */
+    span_t* sp = malloc((numlumps + 2) * sizeof(span_t));
+    uint32_t ns = 0;
+    sp[ns++] = (span_t){ 0, 12 };
+    if (numlumps) sp[ns++] = (span_t){ dirofs, dirofs + numlumps * 16 };
+    for (uint32_t i = 0; i < numlumps; i++) {
+        const uint8_t* d = wad + dirofs + i * 16;
+        uint32_t pos = rd32(d), len = rd32(d + 4);
+        if (!len) continue;
+        if (pos > size || len > size - pos) { fprintf(stderr, "lump %u fuera del fichero\n", i); return 1; }
+        sp[ns++] = (span_t){ pos, pos + len };
+    }
+    qsort(sp, ns, sizeof(span_t), span_cmp);
+    uint32_t m = 0;
+    for (uint32_t i = 0; i < ns; i++) {
+        if (m && sp[i].start < sp[m - 1].end) {
+            if (sp[i].end > sp[m - 1].end) sp[m - 1].end = sp[i].end;
+        } else {
+            sp[m++] = sp[i];
+        }
+    }
+
+    uint32_t hdr = sizeof(wadlz4_header_t) + m * sizeof(wadlz4_extent_t);
+    uint8_t* out = malloc(hdr + size + size / 255 + 16 * m + 16);
+    uint8_t* tmp = malloc(size + size / 255 + 16);
+    uint8_t* chk = malloc(size);
+    uint32_t cpos = hdr;
+
+    for (uint32_t i = 0; i < m; i++) {
+        uint32_t vlen = sp[i].end - sp[i].start;
+        const uint8_t* src = wad + sp[i].start;
+        uint32_t clen = lz4_compress(src, vlen, tmp);
+        if (clen < vlen) {
+            if (lz4_decompress(tmp, clen, chk, vlen) != (int)vlen || memcmp(chk, src, vlen)) {
+                fprintf(stderr, "verificación fallida en la extensión %u\n", i);
+                return 1;
+            }
+            memcpy(out + cpos, tmp, clen);
+        } else {
+            clen = vlen;                        /* no compensa: se guarda tal cual */
+            memcpy(out + cpos, src, vlen);
+        }
+        uint8_t* e = out + sizeof(wadlz4_header_t) + i * sizeof(wadlz4_extent_t);
+        put32(e + 0, sp[i].start);
+        put32(e + 4, vlen);
+        put32(e + 8, cpos);
+        put32(e + 12, clen);
+        cpos += clen;
+    }
+    memcpy(out, WADLZ4_MAGIC, 4);
+    put32(out + 4, WADLZ4_VERSION);
+    put32(out + 8, size);
+    put32(out + 12, m);
+
+    FILE* fo = fopen(argv[2], "wb");
+    if (!fo || fwrite(out, 1, cpos, fo) != cpos || fclose(fo)) { perror(argv[2]); return 1; }
+    printf("%s: %u -> %u bytes (%u%%), %u extensiones\n", argv[2], size, cpos,
+           (unsigned)((uint64_t)cpos * 100 / size), m);
+    return 0;
+}